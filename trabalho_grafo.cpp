@@ -3,6 +3,40 @@
 #include <algorithm> // Para funções como sort()
 #include <limits>    // Para valores de infinito
 #include <queue>     // Para uso em BFS e outros algoritmos
+#include <functional> // Para greater<> nos heaps de prioridade
+#include <map>       // Para indexar arestas da árvore geradora dinâmica
+#include <set>       // Para ordenar por peso as arestas fora da árvore dinâmica
+#include <memory>    // Para compartilhar linhas entre versões do grafo
+#include <atomic>    // Para publicação de versões e épocas dos leitores
+#include <mutex>     // Para serializar escritores
+#include <thread>    // Para leitores e escritores concorrentes
+#include <condition_variable> // Para o pool de threads trabalhadoras
+#include <string>    // Para linhas de consulta e respostas
+#include <fstream>   // Para carregar grafos de arquivo
+#include <cstdio>    // Para sscanf na leitura das consultas
+#include <cstdlib>   // Para atoi e abs
+#include <cmath>     // Para dimensionar o esboço count-min
+#include <chrono>    // Para medir a vazão do modo servidor
+#include <random>    // Para os geradores de grafos sintéticos
+#include <iomanip>   // Para formatar a tabela do benchmark
+#include <sstream>   // Para exportar estatísticas em JSON
+#include <deque>     // Janela de tempo da ingestão em fluxo
+#include <unordered_map> // Última chegada de cada aresta na janela
+#include <new>       // Construção do controle do motor BSP em memória compartilhada
+#ifdef __linux__
+#include <sys/resource.h> // Para medir o pico de memória (getrusage)
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#define GRAFO_PROCESSOS      // Motor BSP com processos (fork) e memória compartilhada
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+#ifdef _WIN32
+#include <direct.h>  // Para _mkdir e _rmdir (diretório temporário do modo externo)
+#include <process.h> // Para _getpid
+#endif
 
 using namespace std;
 
@@ -29,6 +63,96 @@ struct Aresta
     }
 };
 
+// Instrumentação opcional dos algoritmos. Compile com -DGRAFO_INSTRUMENTACAO para
+// ativar os contadores; sem a flag, INSTRUMENTA(...) desaparece e não há custo algum
+#ifdef GRAFO_INSTRUMENTACAO
+#define INSTRUMENTA(...) __VA_ARGS__
+#else
+#define INSTRUMENTA(...)
+#endif
+
+// Contadores e tempos por fase de uma execução de algoritmo
+struct EstatisticasAlgoritmo
+{
+    const char *algoritmo;           // Nome do algoritmo medido
+    long long arestasExaminadas;     // Arestas percorridas
+    long long relaxamentos;          // Arestas que melhoraram uma distância ou chave
+    long long insercoesHeap;         // Inserções no heap de prioridade
+    long long remocoesHeap;          // Remoções do heap de prioridade
+    long long verticesFinalizados;   // Vértices com resultado definitivo
+    long long operacoesFind;         // Chamadas de find no Union-Find (incluindo recursão)
+    long long operacoesUniao;        // Chamadas de unir no Union-Find
+    vector<int> tamanhoFronteira;    // Vértices por nível da BFS
+    vector<pair<string, double>> fases; // Tempo de cada fase em milissegundos
+    chrono::steady_clock::time_point ultimaMarca; // Início da fase atual
+
+    EstatisticasAlgoritmo()
+    {
+        inicia("");
+    }
+
+    // Zera os contadores e começa a medir a primeira fase
+    void inicia(const char *nome)
+    {
+        algoritmo = nome;
+        arestasExaminadas = relaxamentos = 0;
+        insercoesHeap = remocoesHeap = verticesFinalizados = 0;
+        operacoesFind = operacoesUniao = 0;
+        tamanhoFronteira.clear();
+        fases.clear();
+        ultimaMarca = chrono::steady_clock::now();
+    }
+
+    // Encerra a fase atual com o nome dado e começa a próxima
+    void marcaFase(const char *nome)
+    {
+        chrono::steady_clock::time_point agora = chrono::steady_clock::now();
+        fases.push_back(make_pair(string(nome), chrono::duration<double, milli>(agora - ultimaMarca).count()));
+        ultimaMarca = agora;
+    }
+
+    // Conta um vértice alcançado no nível dado da BFS
+    void registraNivel(int nivel)
+    {
+        if ((int)tamanhoFronteira.size() <= nivel)
+            tamanhoFronteira.resize(nivel + 1, 0);
+        tamanhoFronteira[nivel]++;
+    }
+
+    // Exporta as estatísticas como objeto JSON em uma linha
+    string paraJSON() const
+    {
+        ostringstream json;
+        json << "{\"algoritmo\":\"" << algoritmo << "\""
+             << ",\"arestasExaminadas\":" << arestasExaminadas
+             << ",\"relaxamentos\":" << relaxamentos
+             << ",\"insercoesHeap\":" << insercoesHeap
+             << ",\"remocoesHeap\":" << remocoesHeap
+             << ",\"verticesFinalizados\":" << verticesFinalizados
+             << ",\"operacoesFind\":" << operacoesFind
+             << ",\"operacoesUniao\":" << operacoesUniao
+             << ",\"niveisBFS\":" << tamanhoFronteira.size()
+             << ",\"tamanhoFronteira\":[";
+        for (size_t i = 0; i < tamanhoFronteira.size(); i++)
+        {
+            json << (i ? "," : "") << tamanhoFronteira[i];
+        }
+        json << "],\"fasesMs\":{";
+        for (size_t i = 0; i < fases.size(); i++)
+        {
+            json << (i ? "," : "") << "\"" << fases[i].first << "\":" << fases[i].second;
+        }
+        json << "}}";
+        return json.str();
+    }
+
+    // Exibe as estatísticas após o resultado de um algoritmo do menu
+    void exibe() const
+    {
+        cout << "Estatisticas: " << paraJSON() << endl;
+    }
+};
+
 // Classe Union-Find (Conjuntos Disjuntos) para o algoritmo de Kruskal
 // Permite verificar e unir conjuntos eficientemente para detectar ciclos
 class DisjointSet
@@ -36,11 +160,20 @@ class DisjointSet
 private:
     vector<int> pai;  // Vetor que guarda o pai de cada elemento
     vector<int> rank; // Vetor que guarda a altura (rank) de cada árvore
+#ifdef GRAFO_INSTRUMENTACAO
+    EstatisticasAlgoritmo *estatisticas; // Contadores opcionais (instrumentação)
+#endif
 
 public:
     // Construtor - inicializa cada elemento como seu próprio pai
-    DisjointSet(int n)
+    // (est só é guardado com GRAFO_INSTRUMENTACAO)
+    DisjointSet(int n, EstatisticasAlgoritmo *est = nullptr)
     {
+#ifdef GRAFO_INSTRUMENTACAO
+        estatisticas = est;
+#else
+        (void)est;
+#endif
         pai.resize(n);
         rank.resize(n, 0);
         for (int i = 0; i < n; i++)
@@ -53,6 +186,7 @@ public:
     // A compressão de caminho reduz a altura da árvore, tornando buscas futuras mais rápidas
     int find(int x)
     {
+        INSTRUMENTA(if (estatisticas) estatisticas->operacoesFind++);
         if (pai[x] != x)
         {
             pai[x] = find(pai[x]); // Atualiza o pai diretamente para a raiz
@@ -64,6 +198,7 @@ public:
     // Esta técnica ajuda a manter as árvores mais baixas possíveis
     void unir(int x, int y)
     {
+        INSTRUMENTA(if (estatisticas) estatisticas->operacoesUniao++);
         // Encontra as raízes dos conjuntos
         int raizX = find(x);
         int raizY = find(y);
@@ -90,6 +225,435 @@ public:
     }
 };
 
+// Área de trabalho reutilizável pelas consultas (BFS, Dijkstra, Prim).
+// Cada posição guarda o número da consulta em que foi escrita, então reiniciar
+// para uma nova consulta é O(1): posições com carimbo antigo valem "infinito"
+class EspacoTrabalho
+{
+private:
+    vector<int> dist;               // Distância (ou chave, no Prim) de cada vértice
+    vector<int> pai;                // Pai de cada vértice na árvore da consulta
+    vector<unsigned> carimbo;       // Consulta em que dist/pai foram escritos
+    vector<unsigned> carimboFinal;  // Consulta em que o vértice foi finalizado
+    vector<pair<int, int>> heap;    // Heap mínimo de pares (distância, vértice)
+    unsigned consulta;              // Número da consulta atual
+
+public:
+    enum { INF = 999999 }; // Valor que representa "infinito"
+
+    vector<int> alcancados; // Vértices alcançados na consulta atual, em ordem de descoberta
+#ifdef GRAFO_INSTRUMENTACAO
+    EstatisticasAlgoritmo estatisticas; // Contadores da última consulta
+#endif
+
+    EspacoTrabalho() : consulta(0) {}
+
+    // Prepara uma nova consulta sobre um grafo com n vértices
+    void inicia(int n)
+    {
+        if ((int)carimbo.size() < n)
+        {
+            dist.resize(n);
+            pai.resize(n);
+            carimbo.resize(n, 0);
+            carimboFinal.resize(n, 0);
+        }
+
+        consulta++;
+        if (consulta == 0) // Contador deu a volta - única vez em que os carimbos são limpos
+        {
+            fill(carimbo.begin(), carimbo.end(), 0u);
+            fill(carimboFinal.begin(), carimboFinal.end(), 0u);
+            consulta = 1;
+        }
+        alcancados.clear();
+        heap.clear();
+    }
+
+    // Verifica se v já foi alcançado na consulta atual
+    bool alcancado(int v) const
+    {
+        return carimbo[v] == consulta;
+    }
+
+    // Distância de v na consulta atual (INF se não alcançado)
+    int distancia(int v) const
+    {
+        return carimbo[v] == consulta ? dist[v] : (int)INF;
+    }
+
+    // Pai de v na consulta atual (-1 se não houver)
+    int paiDe(int v) const
+    {
+        return carimbo[v] == consulta ? pai[v] : -1;
+    }
+
+    // Define distância e pai de v, registrando-o como alcançado
+    void defineDistancia(int v, int d, int p)
+    {
+        if (carimbo[v] != consulta)
+        {
+            carimbo[v] = consulta;
+            alcancados.push_back(v);
+        }
+        dist[v] = d;
+        pai[v] = p;
+    }
+
+    // Verifica se v já foi finalizado (retirado do heap) na consulta atual
+    bool finalizado(int v) const
+    {
+        return carimboFinal[v] == consulta;
+    }
+
+    // Marca v como finalizado
+    void finaliza(int v)
+    {
+        carimboFinal[v] = consulta;
+    }
+
+    // Insere (d, v) no heap
+    void empilha(int d, int v)
+    {
+        INSTRUMENTA(estatisticas.insercoesHeap++);
+        heap.push_back(make_pair(d, v));
+        push_heap(heap.begin(), heap.end(), greater<pair<int, int>>());
+    }
+
+    // Remove e retorna o par de menor distância do heap
+    pair<int, int> desempilha()
+    {
+        INSTRUMENTA(estatisticas.remocoesHeap++);
+        pop_heap(heap.begin(), heap.end(), greater<pair<int, int>>());
+        pair<int, int> topo = heap.back();
+        heap.pop_back();
+        return topo;
+    }
+
+    // Verifica se o heap está vazio
+    bool heapVazio() const
+    {
+        return heap.empty();
+    }
+
+    // Área de trabalho exclusiva da thread atual
+    static EspacoTrabalho &daThread()
+    {
+        static thread_local EspacoTrabalho ws;
+        return ws;
+    }
+};
+
+// Distâncias da última consulta de uma área de trabalho, lidas sem cópia.
+// Vale até a próxima consulta na mesma área de trabalho
+class DistanciasConsulta
+{
+private:
+    const EspacoTrabalho &ws; // Área de trabalho da consulta
+
+public:
+    explicit DistanciasConsulta(const EspacoTrabalho &area) : ws(area) {}
+
+    // Distância até v (INF se não alcançado)
+    int operator[](int v) const
+    {
+        return ws.distancia(v);
+    }
+
+    // Vértices alcançados, em ordem de descoberta
+    const vector<int> &alcancados() const
+    {
+        return ws.alcancados;
+    }
+};
+
+// Os algoritmos abaixo funcionam sobre qualquer representação que ofereça numVertices
+// e paraCadaVizinho(u, f), chamando f(vizinho, peso) para cada aresta que sai de u.
+// Todo o estado fica no EspacoTrabalho, então o custo é proporcional ao que é explorado;
+// com GRAFO_INSTRUMENTACAO, os contadores da execução ficam em ws.estatisticas
+
+// BFS a partir de origem; para ao retirar destino da fila (se informado)
+template <typename Fonte>
+void buscaLargura(const Fonte &grafo, int origem, EspacoTrabalho &ws, int destino = -1)
+{
+    INSTRUMENTA(ws.estatisticas.inicia("bfs"));
+    ws.inicia(grafo.numVertices);
+    ws.defineDistancia(origem, 0, -1);
+    INSTRUMENTA(ws.estatisticas.marcaFase("inicializacao"));
+
+    // A lista de alcançados serve de fila, pois guarda a ordem de descoberta
+    for (size_t i = 0; i < ws.alcancados.size(); i++)
+    {
+        int u = ws.alcancados[i];
+        int du = ws.distancia(u);
+        INSTRUMENTA(ws.estatisticas.verticesFinalizados++, ws.estatisticas.registraNivel(du));
+        if (u == destino)
+            break;
+
+        grafo.paraCadaVizinho(u, [&](int w, int)
+                              {
+            INSTRUMENTA(ws.estatisticas.arestasExaminadas++);
+            if (!ws.alcancado(w))
+            {
+                INSTRUMENTA(ws.estatisticas.relaxamentos++);
+                ws.defineDistancia(w, du + 1, u);
+            } });
+    }
+    INSTRUMENTA(ws.estatisticas.marcaFase("busca"));
+}
+
+// Dijkstra com heap binário a partir de origem; para ao finalizar destino (se informado)
+template <typename Fonte>
+void caminhosMinimos(const Fonte &grafo, int origem, EspacoTrabalho &ws, int destino = -1)
+{
+    INSTRUMENTA(ws.estatisticas.inicia("dijkstra"));
+    ws.inicia(grafo.numVertices);
+    ws.defineDistancia(origem, 0, -1);
+    ws.empilha(0, origem);
+    INSTRUMENTA(ws.estatisticas.marcaFase("inicializacao"));
+
+    while (!ws.heapVazio())
+    {
+        pair<int, int> topo = ws.desempilha();
+        int u = topo.second;
+        if (ws.finalizado(u))
+            continue; // Entrada desatualizada
+        ws.finaliza(u);
+        INSTRUMENTA(ws.estatisticas.verticesFinalizados++);
+        if (u == destino)
+            break;
+
+        int du = topo.first;
+        grafo.paraCadaVizinho(u, [&](int w, int peso)
+                              {
+            INSTRUMENTA(ws.estatisticas.arestasExaminadas++);
+            if (!ws.finalizado(w) && du + peso < ws.distancia(w))
+            {
+                INSTRUMENTA(ws.estatisticas.relaxamentos++);
+                ws.defineDistancia(w, du + peso, u);
+                ws.empilha(du + peso, w);
+            } });
+    }
+    INSTRUMENTA(ws.estatisticas.marcaFase("busca"));
+}
+
+// Prim com heap binário a partir de raiz; a "distância" de cada vértice é o peso
+// da aresta que o liga ao pai na árvore
+template <typename Fonte>
+void arvorePrim(const Fonte &grafo, int raiz, EspacoTrabalho &ws)
+{
+    INSTRUMENTA(ws.estatisticas.inicia("prim"));
+    ws.inicia(grafo.numVertices);
+    ws.defineDistancia(raiz, 0, -1);
+    ws.empilha(0, raiz);
+    INSTRUMENTA(ws.estatisticas.marcaFase("inicializacao"));
+
+    while (!ws.heapVazio())
+    {
+        int u = ws.desempilha().second;
+        if (ws.finalizado(u))
+            continue;
+        ws.finaliza(u);
+        INSTRUMENTA(ws.estatisticas.verticesFinalizados++);
+
+        grafo.paraCadaVizinho(u, [&](int w, int peso)
+                              {
+            INSTRUMENTA(ws.estatisticas.arestasExaminadas++);
+            if (!ws.finalizado(w) && peso < ws.distancia(w))
+            {
+                INSTRUMENTA(ws.estatisticas.relaxamentos++);
+                ws.defineDistancia(w, peso, u);
+                ws.empilha(peso, w);
+            } });
+    }
+    INSTRUMENTA(ws.estatisticas.marcaFase("arvore"));
+}
+
+// Kruskal: retorna as arestas da Árvore Geradora Mínima e guarda o custo em custoTotal
+// (com GRAFO_INSTRUMENTACAO, preenche estatisticas se informado)
+template <typename Fonte>
+vector<Aresta> arvoreKruskal(const Fonte &grafo, int &custoTotal, EstatisticasAlgoritmo *estatisticas = nullptr)
+{
+    INSTRUMENTA(if (estatisticas) estatisticas->inicia("kruskal"));
+    vector<Aresta> arestas;
+
+    // Coleta todas as arestas do grafo (não direcionado)
+    // Armazena apenas arestas onde origem < destino para evitar duplicação
+    for (int i = 0; i < grafo.numVertices; i++)
+    {
+        grafo.paraCadaVizinho(i, [&](int w, int peso)
+                              {
+            if (i < w)
+            {
+                Aresta e;
+                e.origem = i;
+                e.destino = w;
+                e.peso = peso;
+                arestas.push_back(e);
+            } });
+    }
+    INSTRUMENTA(if (estatisticas) estatisticas->marcaFase("coleta"));
+
+    // Ordena arestas por peso (crescente)
+    sort(arestas.begin(), arestas.end());
+    INSTRUMENTA(if (estatisticas) estatisticas->marcaFase("ordenacao"));
+
+    DisjointSet ds(grafo.numVertices, estatisticas); // Inicializa Union-Find
+    vector<Aresta> mst;                              // Armazena arestas da MST
+    custoTotal = 0;                                  // Custo total da MST
+
+    // Algoritmo principal de Kruskal
+    for (auto &aresta : arestas)
+    {
+        INSTRUMENTA(if (estatisticas) estatisticas->arestasExaminadas++);
+
+        // Verifica se adicionar a aresta não forma ciclo
+        if (ds.find(aresta.origem) != ds.find(aresta.destino))
+        {
+            mst.push_back(aresta);                  // Adiciona à MST
+            ds.unir(aresta.origem, aresta.destino); // Une os conjuntos
+            custoTotal += aresta.peso;              // Atualiza custo total
+        }
+    }
+    INSTRUMENTA(if (estatisticas) estatisticas->marcaFase("uniao"));
+
+    return mst;
+}
+
+// Marca de posição livre no índice de arestas
+const unsigned long long CHAVE_VAZIA = ~0ULL;
+
+// Tabela hash de endereçamento aberto (sondagem linear) que associa cada arco (u, v)
+// ao seu elemento na lista de adjacência. Busca, inserção e remoção em O(1) esperado
+class IndiceArestas
+{
+private:
+    vector<unsigned long long> chaves; // Arco codificado como (u << 32) | v
+    vector<ElemLista *> elementos;     // Elemento da lista correspondente a cada chave
+    size_t ocupados;                   // Número de chaves guardadas
+
+    // Codifica o arco em 64 bits
+    static unsigned long long chave(int u, int v)
+    {
+        return ((unsigned long long)(unsigned)u << 32) | (unsigned)v;
+    }
+
+    // Posição ideal da chave (mistura de bits do splitmix64)
+    size_t posicaoIdeal(unsigned long long c) const
+    {
+        c ^= c >> 30;
+        c *= 0xbf58476d1ce4e5b9ULL;
+        c ^= c >> 27;
+        c *= 0x94d049bb133111ebULL;
+        c ^= c >> 31;
+        return (size_t)c & (chaves.size() - 1);
+    }
+
+    // Posição da chave na tabela, ou da vaga onde ela entraria
+    size_t procura(unsigned long long c) const
+    {
+        size_t i = posicaoIdeal(c);
+        while (chaves[i] != CHAVE_VAZIA && chaves[i] != c)
+        {
+            i = (i + 1) & (chaves.size() - 1);
+        }
+        return i;
+    }
+
+    // Realoca a tabela com a capacidade dada (potência de 2)
+    void redimensiona(size_t capacidade)
+    {
+        vector<unsigned long long> chavesAntigas;
+        vector<ElemLista *> elementosAntigos;
+        chavesAntigas.swap(chaves);
+        elementosAntigos.swap(elementos);
+        chaves.assign(capacidade, CHAVE_VAZIA);
+        elementos.assign(capacidade, nullptr);
+
+        for (size_t i = 0; i < chavesAntigas.size(); i++)
+        {
+            if (chavesAntigas[i] != CHAVE_VAZIA)
+            {
+                size_t j = procura(chavesAntigas[i]);
+                chaves[j] = chavesAntigas[i];
+                elementos[j] = elementosAntigos[i];
+            }
+        }
+    }
+
+public:
+    IndiceArestas() : ocupados(0) {}
+
+    // Retorna o elemento do arco (u, v) ou nullptr se ele não estiver indexado
+    ElemLista *busca(int u, int v) const
+    {
+        if (ocupados == 0)
+            return nullptr;
+        size_t i = procura(chave(u, v));
+        return chaves[i] == CHAVE_VAZIA ? nullptr : elementos[i];
+    }
+
+    // Indexa o arco (u, v); o arco não pode estar indexado
+    void insere(int u, int v, ElemLista *elemento)
+    {
+        // Mantém a ocupação abaixo de 50% para sondagens curtas
+        if ((ocupados + 1) * 2 > chaves.size())
+            redimensiona(chaves.empty() ? 16 : chaves.size() * 2);
+
+        size_t i = procura(chave(u, v));
+        chaves[i] = chave(u, v);
+        elementos[i] = elemento;
+        ocupados++;
+    }
+
+    // Remove o arco (u, v) do índice, se presente.
+    // Desloca para trás as chaves seguintes do mesmo agrupamento, sem deixar lápides
+    void remove(int u, int v)
+    {
+        if (ocupados == 0)
+            return;
+        size_t i = procura(chave(u, v));
+        if (chaves[i] == CHAVE_VAZIA)
+            return;
+
+        size_t mascara = chaves.size() - 1;
+        size_t j = i;
+        while (true)
+        {
+            j = (j + 1) & mascara;
+            if (chaves[j] == CHAVE_VAZIA)
+                break;
+
+            // A chave em j só pode ocupar o buraco i se sua posição ideal não estiver entre i e j
+            size_t k = posicaoIdeal(chaves[j]);
+            bool permanece = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+            if (!permanece)
+            {
+                chaves[i] = chaves[j];
+                elementos[i] = elementos[j];
+                i = j;
+            }
+        }
+        chaves[i] = CHAVE_VAZIA;
+        elementos[i] = nullptr;
+        ocupados--;
+    }
+
+    // Remove todos os arcos
+    void limpa()
+    {
+        chaves.clear();
+        elementos.clear();
+        ocupados = 0;
+    }
+
+    // Número de arcos indexados
+    size_t tamanho() const
+    {
+        return ocupados;
+    }
+};
+
 // Classe principal que implementa um grafo usando lista de adjacência
 class Grafo
 {
@@ -100,6 +664,15 @@ public:
     bool ponderado;   // Define se o grafo tem pesos nas arestas
     ElemLista **A;    // Array de listas de adjacência
 
+    // Listas com pelo menos este grau passam a ter seus arcos no índice hash;
+    // abaixo disso percorrer a lista é tão rápido quanto consultar a tabela
+    static const int GRAU_MINIMO_INDICE = 16;
+
+    vector<int> grau;               // Tamanho de cada lista de adjacência
+    vector<ElemLista *> ultimo;     // Último elemento de cada lista (inserção ordenada em O(1))
+    vector<bool> linhaIndexada;     // Indica se os arcos da lista estão no índice
+    IndiceArestas indice;           // Índice hash dos arcos das listas de grau alto
+
     // Construtor do grafo
     Grafo(int vertices, bool direcionado = false, bool ponderado = true)
     {
@@ -114,26 +687,73 @@ public:
         {
             A[i] = nullptr;
         }
+        grau.assign(vertices, 0);
+        ultimo.assign(vertices, nullptr);
+        linhaIndexada.assign(vertices, false);
+    }
+
+    // Coloca todos os arcos da lista de v no índice
+    void indexaLinha(int v)
+    {
+        for (ElemLista *atual = A[v]; atual != nullptr; atual = atual->prox)
+        {
+            indice.insere(v, atual->vertice, atual);
+        }
+        linhaIndexada[v] = true;
+    }
+
+    // Recalcula graus, últimos elementos e índice a partir das listas
+    // (necessário quando as listas são montadas diretamente em A)
+    void reconstroiIndice()
+    {
+        indice.limpa();
+        for (int v = 0; v < numVertices; v++)
+        {
+            grau[v] = 0;
+            ultimo[v] = nullptr;
+            linhaIndexada[v] = false;
+            for (ElemLista *atual = A[v]; atual != nullptr; atual = atual->prox)
+            {
+                grau[v]++;
+                ultimo[v] = atual;
+            }
+            if (grau[v] >= GRAU_MINIMO_INDICE)
+                indexaLinha(v);
+        }
     }
 
     // Método auxiliar para inserir aresta na lista de adjacência
     // Mantém a lista ordenada por vértice de destino
     bool insereArestaAux(int v1, int v2, int peso)
     {
+        // Em listas indexadas a duplicata é detectada sem percorrer a lista
+        if (linhaIndexada[v1] && indice.busca(v1, v2) != nullptr)
+        {
+            return false; // Aresta já existe, não insere
+        }
+
         ElemLista *ant = nullptr;
         ElemLista *atual = A[v1];
 
-        // Busca posição correta para inserir (mantendo ordem crescente de vértices)
-        while (atual != nullptr && atual->vertice < v2)
+        if (ultimo[v1] != nullptr && ultimo[v1]->vertice < v2)
         {
-            ant = atual;
-            atual = atual->prox;
+            ant = ultimo[v1]; // Maior que todos os vizinhos: insere no final direto
+            atual = nullptr;
         }
-
-        // Verifica se a aresta já existe
-        if (atual != nullptr && atual->vertice == v2)
+        else
         {
-            return false; // Aresta já existe, não insere
+            // Busca posição correta para inserir (mantendo ordem crescente de vértices)
+            while (atual != nullptr && atual->vertice < v2)
+            {
+                ant = atual;
+                atual = atual->prox;
+            }
+
+            // Verifica se a aresta já existe
+            if (atual != nullptr && atual->vertice == v2)
+            {
+                return false; // Aresta já existe, não insere
+            }
         }
 
         // Cria novo elemento para a lista
@@ -151,6 +771,17 @@ public:
         {
             A[v1] = novo; // Insere no início da lista
         }
+        if (atual == nullptr)
+        {
+            ultimo[v1] = novo;
+        }
+
+        // Atualiza o índice (a lista entra nele ao atingir o grau mínimo)
+        grau[v1]++;
+        if (linhaIndexada[v1])
+            indice.insere(v1, v2, novo);
+        else if (grau[v1] >= GRAU_MINIMO_INDICE)
+            indexaLinha(v1);
 
         return true; // Aresta inserida com sucesso
     }
@@ -217,135 +848,215 @@ public:
         }
     }
 
-    // Implementação do algoritmo BFS (Busca em Largura)
-    // Calcula distâncias mínimas em grafo não ponderado
-    void algoritmoBFS(int v)
+    // Insere na lista de v1, em uma única passada, os arcos de arcos[inicio, fim)
+    // (ordenados por destino); repetições mantêm a primeira ocorrência.
+    // Retorna quantos arcos foram inseridos
+    int intercalaLinha(int v1, const vector<Aresta> &arcos, size_t inicio, size_t fim)
     {
-        const int INF = 999999;                 // Valor que representa "infinito"
-        int *dist = new int[numVertices];       // Array de distâncias
-        bool *visitado = new bool[numVertices]; // Marca vértices visitados
-
-        // Inicializa distâncias como infinito e vértices como não visitados
-        for (int i = 0; i < numVertices; i++)
-        {
-            dist[i] = INF;
-            visitado[i] = false;
-        }
-
-        queue<int> fila; // Fila para BFS
-        dist[v] = 0;     // Distância do vértice inicial para ele mesmo é 0
-        visitado[v] = true;
-        fila.push(v);
+        ElemLista *ant = nullptr;
+        ElemLista *atual = A[v1];
+        int inseridos = 0;
 
-        // Processa a BFS
-        while (!fila.empty())
+        for (size_t i = inicio; i < fim; i++)
         {
-            int u = fila.front();
-            fila.pop();
+            int v2 = arcos[i].destino;
+            if (i > inicio && arcos[i - 1].destino == v2)
+                continue; // Repetição dentro do lote
 
-            // Explora todos os vizinhos
-            ElemLista *vizinho = A[u];
-            while (vizinho != nullptr)
+            // A posição só avança: cada elemento da lista é visitado uma vez no lote todo
+            while (atual != nullptr && atual->vertice < v2)
             {
-                int w = vizinho->vertice;
-
-                // Se o vizinho não foi visitado
-                if (!visitado[w])
-                {
-                    visitado[w] = true;
-                    dist[w] = dist[u] + 1; // Distância é a distância do pai + 1
-                    fila.push(w);
-                }
-
-                vizinho = vizinho->prox;
+                ant = atual;
+                atual = atual->prox;
             }
-        }
+            if (atual != nullptr && atual->vertice == v2)
+                continue; // Aresta já existe
 
-        // Exibe as distâncias calculadas
-        cout << "\nDistancias a partir do vertice " << v << " (usando BFS):\n";
-        for (int i = 0; i < numVertices; i++)
-        {
-            if (dist[i] == INF)
-                cout << "Vertice " << i << ": INFINITO\n";
+            ElemLista *novo = new ElemLista();
+            novo->vertice = v2;
+            novo->peso = ponderado ? arcos[i].peso : 1;
+            novo->prox = atual;
+            if (ant != nullptr)
+                ant->prox = novo;
             else
-                cout << "Vertice " << i << ": " << dist[i] << "\n";
+                A[v1] = novo;
+            if (atual == nullptr)
+                ultimo[v1] = novo;
+            ant = novo;
+
+            grau[v1]++;
+            if (linhaIndexada[v1])
+                indice.insere(v1, v2, novo);
+            inseridos++;
         }
 
-        // Libera memória alocada
-        delete[] dist;
-        delete[] visitado;
+        if (!linhaIndexada[v1] && grau[v1] >= GRAU_MINIMO_INDICE)
+            indexaLinha(v1);
+        return inseridos;
     }
 
-    // Implementação do algoritmo de Dijkstra para caminhos mínimos em grafos ponderados
-    void algoritmoDijkstra(int v)
+    // Remove da lista de v1, em uma única passada, os arcos de arcos[inicio, fim)
+    // (pares (v1, destino) ordenados por destino). Retorna quantos foram removidos
+    int retiraLinha(int v1, const vector<pair<int, int>> &arcos, size_t inicio, size_t fim)
     {
-        const int INF = 999999;                 // Valor que representa "infinito"
-        int *dist = new int[numVertices];       // Array de distâncias
-        bool *visitado = new bool[numVertices]; // Marca vértices processados
-
-        // Inicializa distâncias como infinito e vértices como não visitados
-        for (int i = 0; i < numVertices; i++)
-        {
-            dist[i] = INF;
-            visitado[i] = false;
-        }
-
-        dist[v] = 0; // Distância do vértice inicial para ele mesmo é 0
+        ElemLista *ant = nullptr;
+        ElemLista *atual = A[v1];
+        int removidos = 0;
 
-        // Algoritmo principal de Dijkstra
-        for (int j = 0; j < numVertices - 1; j++)
+        for (size_t i = inicio; i < fim; i++)
         {
-            // Encontra vértice não visitado com menor distância atual
-            int u = -1;
-            int menorDist = INF;
-
-            for (int i = 0; i < numVertices; i++)
+            int v2 = arcos[i].second;
+            while (atual != nullptr && atual->vertice < v2)
             {
-                if (!visitado[i] && dist[i] < menorDist)
-                {
-                    menorDist = dist[i];
-                    u = i;
-                }
+                ant = atual;
+                atual = atual->prox;
             }
+            if (atual == nullptr || atual->vertice != v2)
+                continue; // Aresta não existe (ou já removida neste lote)
 
-            // Se não encontrou vértice alcançável, encerra
-            if (u == -1)
-            {
-                break;
-            }
+            ElemLista *prox = atual->prox;
+            if (ant != nullptr)
+                ant->prox = prox;
+            else
+                A[v1] = prox;
+            if (ultimo[v1] == atual)
+                ultimo[v1] = ant;
 
-            visitado[u] = true; // Marca como visitado
+            grau[v1]--;
+            if (linhaIndexada[v1])
+                indice.remove(v1, v2);
+            delete atual;
+            atual = prox;
+            removidos++;
+        }
+        return removidos;
+    }
 
-            // Relaxa todas as arestas saindo do vértice u
-            ElemLista *vizinho = A[u];
-            while (vizinho != nullptr)
+    // Adiciona um lote de arestas com o mesmo resultado de chamar adicionaAresta para
+    // cada uma em ordem, mas percorrendo cada lista uma única vez.
+    // Retorna o número de arestas inseridas
+    int adicionaArestasEmLote(const vector<Aresta> &lote)
+    {
+        vector<Aresta> arcos;
+        arcos.reserve(direcionado ? lote.size() : 2 * lote.size());
+        for (const Aresta &a : lote)
+        {
+            if (a.origem < 0 || a.destino < 0 || a.origem >= numVertices || a.destino >= numVertices || a.origem == a.destino)
             {
-                int v = vizinho->vertice;
-                int peso = vizinho->peso;
+                cout << "Entrada invalida" << endl;
+                continue;
+            }
+            arcos.push_back(a);
+            if (!direcionado)
+                arcos.push_back({a.destino, a.origem, a.peso});
+        }
 
-                // Verifica se encontrou caminho melhor
-                if (!visitado[v] && dist[u] + peso < dist[v])
-                {
-                    dist[v] = dist[u] + peso; // Atualiza distância
-                }
+        // A ordenação estável preserva a ordem de chegada entre arcos repetidos
+        stable_sort(arcos.begin(), arcos.end(), [](const Aresta &a, const Aresta &b)
+                    { return a.origem != b.origem ? a.origem < b.origem : a.destino < b.destino; });
 
-                vizinho = vizinho->prox;
+        int inseridos = 0;
+        for (size_t i = 0, fim; i < arcos.size(); i = fim)
+        {
+            for (fim = i; fim < arcos.size() && arcos[fim].origem == arcos[i].origem; fim++)
+                ;
+            inseridos += intercalaLinha(arcos[i].origem, arcos, i, fim);
+        }
+
+        // Em grafo não direcionado os dois sentidos de cada aresta entram juntos
+        int novas = direcionado ? inseridos : inseridos / 2;
+        numArestas += novas;
+        return novas;
+    }
+
+    // Remove um lote de arestas percorrendo cada lista uma única vez.
+    // Retorna o número de arestas removidas
+    int removeArestasEmLote(const vector<pair<int, int>> &lote)
+    {
+        vector<pair<int, int>> arcos;
+        arcos.reserve(direcionado ? lote.size() : 2 * lote.size());
+        for (const pair<int, int> &a : lote)
+        {
+            if (a.first < 0 || a.second < 0 || a.first >= numVertices || a.second >= numVertices || a.first == a.second)
+            {
+                cout << "Entrada invalida\n";
+                continue;
             }
+            arcos.push_back(a);
+            if (!direcionado)
+                arcos.push_back(make_pair(a.second, a.first));
+        }
+        sort(arcos.begin(), arcos.end());
+
+        int removidos = 0;
+        for (size_t i = 0, fim; i < arcos.size(); i = fim)
+        {
+            for (fim = i; fim < arcos.size() && arcos[fim].first == arcos[i].first; fim++)
+                ;
+            removidos += retiraLinha(arcos[i].first, arcos, i, fim);
+        }
+
+        int retiradas = direcionado ? removidos : removidos / 2;
+        numArestas -= retiradas;
+        return retiradas;
+    }
+
+    // Percorre os vizinhos de u chamando f(vizinho, peso) para cada aresta
+    template <typename Funcao>
+    void paraCadaVizinho(int u, Funcao f) const
+    {
+        for (ElemLista *atual = A[u]; atual != nullptr; atual = atual->prox)
+        {
+            f(atual->vertice, atual->peso);
         }
+    }
 
-        // Exibe as distâncias calculadas
-        cout << "\nDistancias a partir do vertice " << v << " (usando Dijkstra):\n";
+    // Exibe as distâncias guardadas na área de trabalho
+    void exibeDistancias(int v, const EspacoTrabalho &ws, const char *algoritmo)
+    {
+        cout << "\nDistancias a partir do vertice " << v << " (usando " << algoritmo << "):\n";
         for (int i = 0; i < numVertices; i++)
         {
-            if (dist[i] == INF)
+            if (ws.distancia(i) == EspacoTrabalho::INF)
                 cout << "Vertice " << i << ": INFINITO\n";
             else
-                cout << "Vertice " << i << ": " << dist[i] << "\n";
+                cout << "Vertice " << i << ": " << ws.distancia(i) << "\n";
+        }
+    }
+
+    // Implementação do algoritmo BFS (Busca em Largura)
+    // Calcula distâncias mínimas em grafo não ponderado
+    void algoritmoBFS(int v)
+    {
+        // Reutiliza a área de trabalho da thread - nenhuma alocação por consulta
+        // Verifica se o vértice é válido
+        if (v < 0 || v >= numVertices)
+        {
+            cout << "Entrada invalida\n";
+            return;
+        }
+
+        EspacoTrabalho &ws = EspacoTrabalho::daThread();
+        buscaLargura(*this, v, ws);
+        exibeDistancias(v, ws, "BFS");
+        INSTRUMENTA(ws.estatisticas.exibe());
+    }
+
+    // Implementação do algoritmo de Dijkstra para caminhos mínimos em grafos ponderados
+    void algoritmoDijkstra(int v)
+    {
+        // Dijkstra com heap binário sobre a área de trabalho da thread
+        // Verifica se o vértice é válido
+        if (v < 0 || v >= numVertices)
+        {
+            cout << "Entrada invalida\n";
+            return;
         }
 
-        // Libera memória alocada
-        delete[] dist;
-        delete[] visitado;
+        EspacoTrabalho &ws = EspacoTrabalho::daThread();
+        caminhosMinimos(*this, v, ws);
+        exibeDistancias(v, ws, "Dijkstra");
+        INSTRUMENTA(ws.estatisticas.exibe());
     }
 
     // Implementação do algoritmo de Floyd-Warshall para todos os pares de caminhos mínimos
@@ -400,49 +1111,24 @@ public:
         }
     }
 
+    // Calcula a Árvore Geradora Mínima com Kruskal, sem exibir
+    // Retorna as arestas da MST e guarda o custo em custoTotal
+    // (com GRAFO_INSTRUMENTACAO, preenche estatisticas se informado)
+    vector<Aresta> calculaKruskal(int &custoTotal, EstatisticasAlgoritmo *estatisticas = nullptr)
+    {
+        return arvoreKruskal(*this, custoTotal, estatisticas);
+    }
+
     // Implementação do algoritmo de Kruskal para Árvore Geradora Mínima (MST)
     void algoritmoKruskal()
     {
-        vector<Aresta> arestas;
-
-        // Coleta todas as arestas do grafo (não direcionado)
-        // Considerando apenas uma direção para evitar duplicação
-        for (int i = 0; i < numVertices; i++)
-        {
-            ElemLista *atual = A[i];
-            while (atual != nullptr)
-            {
-                // Armazena apenas arestas onde origem < destino para evitar duplicação
-                if (i < atual->vertice)
-                {
-                    Aresta e;
-                    e.origem = i;
-                    e.destino = atual->vertice;
-                    e.peso = atual->peso;
-                    arestas.push_back(e);
-                }
-                atual = atual->prox;
-            }
-        }
-
-        // Ordena arestas por peso (crescente)
-        sort(arestas.begin(), arestas.end());
-
-        DisjointSet ds(numVertices); // Inicializa Union-Find
-        vector<Aresta> mst;          // Armazena arestas da MST
-        int custoTotal = 0;          // Custo total da MST
-
-        // Algoritmo principal de Kruskal
-        for (auto &aresta : arestas)
-        {
-            // Verifica se adicionar a aresta não forma ciclo
-            if (ds.find(aresta.origem) != ds.find(aresta.destino))
-            {
-                mst.push_back(aresta);                  // Adiciona à MST
-                ds.unir(aresta.origem, aresta.destino); // Une os conjuntos
-                custoTotal += aresta.peso;              // Atualiza custo total
-            }
-        }
+        int custoTotal;
+#ifdef GRAFO_INSTRUMENTACAO
+        EstatisticasAlgoritmo estatisticas;
+        vector<Aresta> mst = calculaKruskal(custoTotal, &estatisticas);
+#else
+        vector<Aresta> mst = calculaKruskal(custoTotal);
+#endif
 
         // Exibe a MST encontrada
         cout << "\nArvore Geradora Minima (Kruskal):\n";
@@ -452,56 +1138,16 @@ public:
             cout << aresta.origem << " -- " << aresta.destino << " (peso: " << aresta.peso << ")\n";
         }
         cout << "Custo total da MST: " << custoTotal << endl;
+        INSTRUMENTA(estatisticas.exibe());
     }
 
     // Implementação do algoritmo de Prim para Árvore Geradora Mínima (MST)
     void algoritmoPrim()
     {
-        const int INF = 999999;                    // Valor que representa "infinito"
-        vector<int> chave(numVertices, INF);       // Menor peso para conectar à MST
-        vector<bool> naArvore(numVertices, false); // Vértices já na MST
-        vector<int> pai(numVertices, -1);          // Pai de cada vértice na MST
-
-        chave[0] = 0; // Começa do vértice 0
-
-        // Algoritmo principal de Prim
-        for (int i = 0; i < numVertices - 1; i++)
-        {
-            // Encontra vértice com menor chave (peso) que ainda não está na MST
-            int u = -1;
-            int menorChave = INF;
-            for (int v = 0; v < numVertices; v++)
-            {
-                if (!naArvore[v] && chave[v] < menorChave)
-                {
-                    menorChave = chave[v];
-                    u = v;
-                }
-            }
-
-            // Se não encontrou vértice alcançável, encerra
-            if (u == -1)
-                break;
-
-            naArvore[u] = true; // Adiciona à MST
-
-            // Atualiza chaves dos vértices adjacentes
-            ElemLista *adj = A[u];
-            while (adj != nullptr)
-            {
-                int v = adj->vertice;
-                int peso = adj->peso;
-
-                // Se encontrou aresta de menor peso para alcançar v
-                if (!naArvore[v] && peso < chave[v])
-                {
-                    pai[v] = u;      // Atualiza o pai
-                    chave[v] = peso; // Atualiza a chave
-                }
-
-                adj = adj->prox;
-            }
-        }
+        // Prim com heap binário a partir do vértice 0; a distância de cada vértice
+        // na área de trabalho é o peso da aresta que o liga ao pai
+        EspacoTrabalho &ws = EspacoTrabalho::daThread();
+        arvorePrim(*this, 0, ws);
 
         // Exibe a MST encontrada
         int custoTotal = 0;
@@ -509,29 +1155,14 @@ public:
         cout << "Arestas na MST:\n";
         for (int i = 1; i < numVertices; i++)
         {
-            if (pai[i] != -1)
+            if (ws.paiDe(i) != -1)
             {
-                cout << pai[i] << " -- " << i;
-
-                // Localiza a aresta para obter o peso
-                ElemLista *adj = A[pai[i]];
-                while (adj != nullptr && adj->vertice != i)
-                {
-                    adj = adj->prox;
-                }
-
-                if (adj != nullptr)
-                {
-                    cout << " (peso: " << adj->peso << ")\n";
-                    custoTotal += adj->peso;
-                }
-                else
-                {
-                    cout << " (peso desconhecido)\n";
-                }
+                cout << ws.paiDe(i) << " -- " << i << " (peso: " << ws.distancia(i) << ")\n";
+                custoTotal += ws.distancia(i);
             }
         }
         cout << "Custo total da MST: " << custoTotal << endl;
+        INSTRUMENTA(ws.estatisticas.exibe());
     }
 
     // Verifica se o grafo está conectado usando DFS
@@ -658,6 +1289,12 @@ public:
     // Método auxiliar para remover aresta da lista de adjacência
     bool removeArestaAux(int v1, int v2)
     {
+        // Em listas indexadas a ausência é detectada sem percorrer a lista
+        if (linhaIndexada[v1] && indice.busca(v1, v2) == nullptr)
+        {
+            return false;
+        }
+
         ElemLista *ant = nullptr;
         ElemLista *atual = A[v1];
 
@@ -679,6 +1316,14 @@ public:
             {
                 A[v1] = atual->prox; // Remove do início da lista
             }
+            if (ultimo[v1] == atual)
+            {
+                ultimo[v1] = ant;
+            }
+
+            grau[v1]--;
+            if (linhaIndexada[v1])
+                indice.remove(v1, v2);
 
             delete atual; // Libera memória
             return true;  // Aresta removida com sucesso
@@ -700,137 +1345,5112 @@ public:
         // Remove a aresta
         if (removeArestaAux(v1, v2))
         {
-            removeArestaAux(v2, v1); // Remove em ambas direções para grafo não direcionado
-            numArestas--;
-            return true;
+            if (!direcionado)
+            {
+                removeArestaAux(v2, v1); // Remove em ambas direções para grafo não direcionado
+            }
+            numArestas--;
+            return true;
+        }
+
+        return false; // Aresta não encontrada
+    }
+
+    // Exibe o grafo (lista de adjacência)
+    void exibeGrafo()
+    {
+        for (int i = 0; i < numVertices; i++)
+        {
+            ElemLista *temp = A[i];
+            cout << "Vertice " << i << " -> ";
+
+            // Para cada vértice, exibe seus vizinhos e pesos
+            while (temp != nullptr)
+            {
+                cout << "(" << temp->vertice << ", peso: " << temp->peso << ")";
+                if (temp->prox != nullptr)
+                    cout << " -> ";
+                temp = temp->prox;
+            }
+            cout << endl;
+        }
+    }
+
+    // Verifica se uma aresta existe no grafo
+    bool arestaExiste(int v1, int v2)
+    {
+        // Verifica se os vértices são válidos
+        if (v1 < 0 || v2 < 0 || v1 >= numVertices || v2 >= numVertices || v1 == v2)
+        {
+            cout << "Entrada invalida\n";
+            return false;
+        }
+
+        // Busca a aresta pelo índice ou na lista de adjacência
+        return buscaAresta(v1, v2) != nullptr;
+    }
+
+    // Retorna o elemento da lista de adjacência que representa a aresta v1 -> v2
+    // ou nullptr se a aresta não existir
+    ElemLista *buscaAresta(int v1, int v2)
+    {
+        // Listas de grau alto são consultadas no índice em O(1)
+        if (linhaIndexada[v1])
+        {
+            return indice.busca(v1, v2);
+        }
+
+        ElemLista *atual = A[v1];
+        while (atual != nullptr && atual->vertice < v2)
+        {
+            atual = atual->prox;
+        }
+
+        if (atual != nullptr && atual->vertice == v2)
+        {
+            return atual;
+        }
+        return nullptr;
+    }
+
+    // Altera o peso de uma aresta existente (em ambas direções para grafo não direcionado)
+    bool alteraPesoAresta(int v1, int v2, int peso)
+    {
+        // Verifica se os vértices são válidos
+        if (v1 < 0 || v2 < 0 || v1 >= numVertices || v2 >= numVertices || v1 == v2)
+        {
+            cout << "Entrada invalida\n";
+            return false;
+        }
+
+        ElemLista *aresta = buscaAresta(v1, v2);
+        if (aresta == nullptr)
+        {
+            return false; // Aresta não encontrada
+        }
+
+        aresta->peso = ponderado ? peso : 1;
+        if (!direcionado)
+        {
+            ElemLista *volta = buscaAresta(v2, v1);
+            if (volta != nullptr)
+            {
+                volta->peso = aresta->peso;
+            }
+        }
+        return true;
+    }
+
+    // Destrutor - libera toda a memória alocada
+    ~Grafo()
+    {
+        // Para cada vértice, libera sua lista de adjacência
+        for (int i = 0; i < numVertices; i++)
+        {
+            ElemLista *temp = A[i];
+            while (temp != nullptr)
+            {
+                ElemLista *toDelete = temp;
+                temp = temp->prox;
+                delete toDelete;
+            }
+        }
+
+        // Libera o array de listas
+        delete[] A;
+    }
+};
+
+// Classe que mantém os caminhos mínimos a partir de uma origem fixa e os repara
+// incrementalmente quando arestas são inseridas, removidas ou têm o peso alterado.
+// Segue a ideia de Ramalingam-Reps: uma melhora é propagada apenas a partir do vértice
+// beneficiado, e uma piora recalcula apenas a subárvore de caminhos mínimos afetada
+class CaminhoMinimoDinamico
+{
+private:
+    enum { INF = 999999 }; // Valor que representa "infinito"
+
+    // Fila de prioridade mínima de pares (distância, vértice)
+    typedef priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> FilaMinima;
+
+    Grafo &g;                              // Grafo monitorado
+    int origem;                            // Vértice de origem dos caminhos
+    vector<int> dist;                      // Distância atual de cada vértice
+    vector<int> pred;                      // Predecessor na árvore de caminhos mínimos
+    vector<bool> afetado;                  // Marca temporária dos vértices em reparo
+    vector<vector<pair<int, int>>> entrada; // Arestas de entrada (vizinho, peso) - só para grafo direcionado
+    bool pesosValidos;                     // Falso se o grafo inicial tinha peso negativo
+
+    // O reparo incremental (Ramalingam-Reps) só vale para pesos não negativos: uma
+    // aresta negativa em grafo não direcionado já forma um ciclo negativo
+    bool pesoAceito(int peso) const
+    {
+        if (g.ponderado && peso < 0)
+        {
+            cout << "Peso negativo nao permitido no caminho minimo dinamico\n";
+            return false;
+        }
+        return true;
+    }
+
+    // Dijkstra parcial: propaga as reduções de distância dos vértices que estão na fila
+    void propaga(FilaMinima &fila)
+    {
+        while (!fila.empty())
+        {
+            int d = fila.top().first;
+            int u = fila.top().second;
+            fila.pop();
+
+            // Ignora entradas desatualizadas da fila
+            if (d != dist[u])
+                continue;
+
+            ElemLista *vizinho = g.A[u];
+            while (vizinho != nullptr)
+            {
+                int w = vizinho->vertice;
+                if (dist[u] + vizinho->peso < dist[w])
+                {
+                    dist[w] = dist[u] + vizinho->peso;
+                    pred[w] = u;
+                    fila.push(make_pair(dist[w], w));
+                }
+                vizinho = vizinho->prox;
+            }
+        }
+    }
+
+    // Tenta melhorar a distância de v usando a aresta u -> v
+    void relaxa(int u, int v, int peso, FilaMinima &fila)
+    {
+        if (dist[u] != INF && dist[u] + peso < dist[v])
+        {
+            dist[v] = dist[u] + peso;
+            pred[v] = u;
+            fila.push(make_pair(dist[v], v));
+        }
+    }
+
+    // Recalcula a subárvore de caminhos mínimos enraizada em raiz
+    // (chamado depois que a aresta que ligava raiz ao seu predecessor piorou ou sumiu)
+    void reparaSubarvore(int raiz)
+    {
+        // Coleta os descendentes de raiz na árvore de caminhos mínimos
+        vector<int> afetados;
+        afetados.push_back(raiz);
+        afetado[raiz] = true;
+        for (size_t i = 0; i < afetados.size(); i++)
+        {
+            int y = afetados[i];
+            ElemLista *vizinho = g.A[y];
+            while (vizinho != nullptr)
+            {
+                int x = vizinho->vertice;
+                if (!afetado[x] && pred[x] == y)
+                {
+                    afetado[x] = true;
+                    afetados.push_back(x);
+                }
+                vizinho = vizinho->prox;
+            }
+        }
+
+        // Invalida as distâncias da subárvore
+        for (int x : afetados)
+        {
+            dist[x] = INF;
+            pred[x] = -1;
+        }
+
+        // Cada vértice afetado recebe a melhor distância vinda de um vizinho não afetado
+        FilaMinima fila;
+        for (int x : afetados)
+        {
+            if (x == origem)
+            {
+                dist[x] = 0;
+            }
+            else if (g.direcionado)
+            {
+                for (auto &e : entrada[x])
+                {
+                    if (!afetado[e.first] && dist[e.first] != INF && dist[e.first] + e.second < dist[x])
+                    {
+                        dist[x] = dist[e.first] + e.second;
+                        pred[x] = e.first;
+                    }
+                }
+            }
+            else
+            {
+                ElemLista *vizinho = g.A[x];
+                while (vizinho != nullptr)
+                {
+                    int y = vizinho->vertice;
+                    if (!afetado[y] && dist[y] != INF && dist[y] + vizinho->peso < dist[x])
+                    {
+                        dist[x] = dist[y] + vizinho->peso;
+                        pred[x] = y;
+                    }
+                    vizinho = vizinho->prox;
+                }
+            }
+
+            if (dist[x] != INF)
+            {
+                fila.push(make_pair(dist[x], x));
+            }
+        }
+
+        // Limpa as marcas antes de propagar (apenas vértices afetados podem melhorar)
+        for (int x : afetados)
+        {
+            afetado[x] = false;
+        }
+
+        propaga(fila);
+    }
+
+    // Trata a piora (remoção ou aumento de peso) da aresta u -> v
+    void tratarPiora(int u, int v)
+    {
+        if (pred[v] == u)
+        {
+            reparaSubarvore(v);
+        }
+        else if (!g.direcionado && pred[u] == v)
+        {
+            reparaSubarvore(u);
+        }
+    }
+
+    // Trata a melhora (inserção ou redução de peso) da aresta u -> v
+    void tratarMelhora(int u, int v, int peso)
+    {
+        FilaMinima fila;
+        relaxa(u, v, peso, fila);
+        if (!g.direcionado)
+        {
+            relaxa(v, u, peso, fila);
+        }
+        propaga(fila);
+    }
+
+    // Remove (u, peso) da lista de entrada de v
+    void removeEntrada(int v, int u)
+    {
+        for (size_t i = 0; i < entrada[v].size(); i++)
+        {
+            if (entrada[v][i].first == u)
+            {
+                entrada[v][i] = entrada[v].back();
+                entrada[v].pop_back();
+                return;
+            }
+        }
+    }
+
+public:
+    // Construtor - calcula a árvore inicial de caminhos mínimos com Dijkstra.
+    // Se o grafo já tiver peso negativo, nada é calculado e valido() retorna false
+    CaminhoMinimoDinamico(Grafo &grafo, int verticeOrigem) : g(grafo), origem(verticeOrigem), pesosValidos(true)
+    {
+        dist.assign(g.numVertices, INF);
+        pred.assign(g.numVertices, -1);
+        afetado.assign(g.numVertices, false);
+
+        for (int i = 0; i < g.numVertices && pesosValidos; i++)
+        {
+            for (ElemLista *atual = g.A[i]; atual != nullptr; atual = atual->prox)
+            {
+                if (atual->peso < 0)
+                {
+                    cout << "O grafo possui peso negativo: caminho minimo dinamico indisponivel\n";
+                    pesosValidos = false;
+                    break;
+                }
+            }
+        }
+        if (!pesosValidos)
+            return;
+
+        // Em grafo direcionado as arestas de entrada não estão na lista de adjacência
+        if (g.direcionado)
+        {
+            entrada.resize(g.numVertices);
+            for (int i = 0; i < g.numVertices; i++)
+            {
+                ElemLista *atual = g.A[i];
+                while (atual != nullptr)
+                {
+                    entrada[atual->vertice].push_back(make_pair(i, atual->peso));
+                    atual = atual->prox;
+                }
+            }
+        }
+
+        FilaMinima fila;
+        dist[origem] = 0;
+        fila.push(make_pair(0, origem));
+        propaga(fila);
+    }
+
+    // Adiciona aresta ao grafo e propaga apenas as distâncias que melhoraram
+    bool adicionaAresta(int v1, int v2, int peso)
+    {
+        if (!pesosValidos || !pesoAceito(peso))
+        {
+            return false;
+        }
+
+        int arestasAntes = g.numArestas;
+        g.adicionaAresta(v1, v2, peso);
+        if (g.numArestas == arestasAntes)
+        {
+            return false; // Entrada inválida ou aresta já existente
+        }
+
+        int pesoEfetivo = g.ponderado ? peso : 1;
+        if (g.direcionado)
+        {
+            entrada[v2].push_back(make_pair(v1, pesoEfetivo));
+        }
+        tratarMelhora(v1, v2, pesoEfetivo);
+        return true;
+    }
+
+    // Remove aresta do grafo e recalcula apenas a subárvore que dependia dela
+    bool removeAresta(int v1, int v2)
+    {
+        if (!pesosValidos || !g.removeAresta(v1, v2))
+        {
+            return false;
+        }
+
+        if (g.direcionado)
+        {
+            removeEntrada(v2, v1);
+        }
+        tratarPiora(v1, v2);
+        return true;
+    }
+
+    // Altera o peso de uma aresta, tratando como melhora ou piora conforme o caso
+    bool alteraPeso(int v1, int v2, int peso)
+    {
+        if (v1 < 0 || v2 < 0 || v1 >= g.numVertices || v2 >= g.numVertices || v1 == v2)
+        {
+            cout << "Entrada invalida\n";
+            return false;
+        }
+        if (!pesosValidos || !pesoAceito(peso))
+        {
+            return false;
+        }
+
+        ElemLista *aresta = g.buscaAresta(v1, v2);
+        if (aresta == nullptr)
+        {
+            return false;
+        }
+
+        int pesoAntigo = aresta->peso;
+        g.alteraPesoAresta(v1, v2, peso);
+        int pesoNovo = aresta->peso;
+
+        if (g.direcionado)
+        {
+            for (auto &e : entrada[v2])
+            {
+                if (e.first == v1)
+                    e.second = pesoNovo;
+            }
+        }
+
+        if (pesoNovo < pesoAntigo)
+        {
+            tratarMelhora(v1, v2, pesoNovo);
+        }
+        else if (pesoNovo > pesoAntigo)
+        {
+            tratarPiora(v1, v2);
+        }
+        return true;
+    }
+
+    // Indica se o grafo inicial era aceito (sem pesos negativos)
+    bool valido() const
+    {
+        return pesosValidos;
+    }
+
+    // Retorna a distância atual até v (999999 se inalcançável)
+    int distancia(int v) const
+    {
+        return dist[v];
+    }
+
+    // Retorna o predecessor de v na árvore de caminhos mínimos (-1 se não houver)
+    int predecessor(int v) const
+    {
+        return pred[v];
+    }
+
+    // Exibe as distâncias mantidas
+    void exibeDistancias() const
+    {
+        cout << "\nDistancias a partir do vertice " << origem << " (caminho minimo dinamico):\n";
+        for (int i = 0; i < (int)dist.size(); i++)
+        {
+            if (dist[i] == INF)
+                cout << "Vertice " << i << ": INFINITO\n";
+            else
+                cout << "Vertice " << i << ": " << dist[i] << "\n";
+        }
+    }
+};
+
+// Árvore link-cut (Sleator-Tarjan) sobre árvores splay
+// Mantém uma floresta dinâmica com ligação, corte e consulta do maior valor num caminho,
+// todos em O(log n) amortizado. Usada pela árvore geradora mínima dinâmica
+class ArvoreLinkCut
+{
+private:
+    vector<int> esq, dir, pai; // Filhos e pai na árvore splay (pai também guarda o "path-parent")
+    vector<bool> inverte;      // Marca preguiçosa de inversão da subárvore
+    vector<int> valor;         // Valor associado a cada nó
+    vector<int> maximo;        // Nó de maior valor na subárvore splay
+
+    // Verifica se x é raiz da sua árvore splay
+    bool ehRaiz(int x)
+    {
+        int p = pai[x];
+        return p == -1 || (esq[p] != x && dir[p] != x);
+    }
+
+    // Recalcula o nó de maior valor da subárvore de x
+    void atualiza(int x)
+    {
+        maximo[x] = x;
+        if (esq[x] != -1 && valor[maximo[esq[x]]] > valor[maximo[x]])
+            maximo[x] = maximo[esq[x]];
+        if (dir[x] != -1 && valor[maximo[dir[x]]] > valor[maximo[x]])
+            maximo[x] = maximo[dir[x]];
+    }
+
+    // Propaga a inversão pendente de x para os filhos
+    void empurra(int x)
+    {
+        if (inverte[x])
+        {
+            swap(esq[x], dir[x]);
+            if (esq[x] != -1)
+                inverte[esq[x]] = !inverte[esq[x]];
+            if (dir[x] != -1)
+                inverte[dir[x]] = !inverte[dir[x]];
+            inverte[x] = false;
+        }
+    }
+
+    // Rotação simples de x com o seu pai
+    void rotaciona(int x)
+    {
+        int y = pai[x];
+        int z = pai[y];
+        if (!ehRaiz(y))
+        {
+            if (esq[z] == y)
+                esq[z] = x;
+            else
+                dir[z] = x;
+        }
+        pai[x] = z;
+
+        if (esq[y] == x)
+        {
+            esq[y] = dir[x];
+            if (dir[x] != -1)
+                pai[dir[x]] = y;
+            dir[x] = y;
+        }
+        else
+        {
+            dir[y] = esq[x];
+            if (esq[x] != -1)
+                pai[esq[x]] = y;
+            esq[x] = y;
+        }
+        pai[y] = x;
+
+        atualiza(y);
+        atualiza(x);
+    }
+
+    // Leva x até a raiz da sua árvore splay
+    void splay(int x)
+    {
+        // Propaga as inversões pendentes do topo até x antes de rotacionar
+        vector<int> caminho;
+        caminho.push_back(x);
+        for (int y = x; !ehRaiz(y); y = pai[y])
+        {
+            caminho.push_back(pai[y]);
+        }
+        for (int i = (int)caminho.size() - 1; i >= 0; i--)
+        {
+            empurra(caminho[i]);
+        }
+
+        while (!ehRaiz(x))
+        {
+            int y = pai[x];
+            if (!ehRaiz(y))
+            {
+                int z = pai[y];
+                // Zig-zig rotaciona o pai primeiro, zig-zag rotaciona x duas vezes
+                if ((esq[y] == x) == (esq[z] == y))
+                    rotaciona(y);
+                else
+                    rotaciona(x);
+            }
+            rotaciona(x);
+        }
+    }
+
+    // Torna preferido o caminho da raiz da árvore até x
+    void acessa(int x)
+    {
+        int ultimo = -1;
+        for (int y = x; y != -1; y = pai[y])
+        {
+            splay(y);
+            dir[y] = ultimo;
+            atualiza(y);
+            ultimo = y;
+        }
+        splay(x);
+    }
+
+    // Torna x a raiz da sua árvore
+    void tornaRaiz(int x)
+    {
+        acessa(x);
+        inverte[x] = !inverte[x];
+    }
+
+    // Encontra a raiz da árvore que contém x
+    int encontraRaiz(int x)
+    {
+        acessa(x);
+        empurra(x);
+        while (esq[x] != -1)
+        {
+            x = esq[x];
+            empurra(x);
+        }
+        splay(x);
+        return x;
+    }
+
+public:
+    // Cria um novo nó isolado com o valor dado e retorna seu índice
+    int novoNo(int v)
+    {
+        esq.push_back(-1);
+        dir.push_back(-1);
+        pai.push_back(-1);
+        inverte.push_back(false);
+        valor.push_back(v);
+        maximo.push_back((int)valor.size() - 1);
+        return (int)valor.size() - 1;
+    }
+
+    // Redefine um nó isolado (para reaproveitar índices liberados)
+    void reiniciaNo(int x, int v)
+    {
+        esq[x] = dir[x] = pai[x] = -1;
+        inverte[x] = false;
+        valor[x] = v;
+        maximo[x] = x;
+    }
+
+    // Valor associado ao nó x
+    int valorNo(int x) const
+    {
+        return valor[x];
+    }
+
+    // Verifica se x e y estão na mesma árvore
+    bool conectados(int x, int y)
+    {
+        return encontraRaiz(x) == encontraRaiz(y);
+    }
+
+    // Liga x (que deve estar em outra árvore) como filho de y
+    void conecta(int x, int y)
+    {
+        tornaRaiz(x);
+        pai[x] = y;
+    }
+
+    // Remove a aresta da floresta entre x e y (devem ser adjacentes)
+    void corta(int x, int y)
+    {
+        tornaRaiz(x);
+        acessa(y);
+        // Após acessar y com x como raiz, x é o filho esquerdo de y na árvore splay
+        esq[y] = -1;
+        pai[x] = -1;
+        atualiza(y);
+    }
+
+    // Retorna o nó de maior valor no caminho entre x e y (devem estar conectados)
+    int maximoCaminho(int x, int y)
+    {
+        tornaRaiz(x);
+        acessa(y);
+        return maximo[y];
+    }
+};
+
+// Classe que mantém a Árvore Geradora Mínima (floresta, se o grafo for desconexo)
+// de um grafo não direcionado durante inserções e remoções de arestas,
+// evitando reexecutar Kruskal ou Prim sobre o grafo inteiro a cada alteração.
+// Inserções e remoções de arestas fora da árvore custam O(log V) amortizado pela
+// árvore link-cut. As arestas fora da árvore ficam em conjuntos por vértice ordenados
+// por peso; remover uma aresta da árvore percorre o lado menor do corte e, em cada
+// vértice, só as arestas fora da árvore mais leves que a melhor substituta já achada.
+// Isso NÃO atinge o limite polilogarítmico: no pior caso (corte equilibrado com muitas
+// arestas internas leves) a busca ainda custa O(V + E log V). A estrutura de níveis de
+// Holm-de Lichtenberg-Thorup exigiria a redução decremental -> totalmente dinâmica
+// do artigo, que não foi implementada
+class ArvoreGeradoraDinamica
+{
+private:
+    Grafo &g;                         // Grafo monitorado (não direcionado)
+    ArvoreLinkCut floresta;           // Vértices 0..V-1 e um nó extra para cada aresta da árvore
+    vector<Aresta> arestaDoNo;        // Aresta representada por cada nó de aresta (índice - V)
+    vector<int> nosLivres;            // Nós de aresta liberados para reaproveitamento
+    map<pair<int, int>, int> noDaAresta; // Aresta da árvore (menor, maior) -> nó na floresta
+    vector<vector<int>> adjArvore;    // Lista de adjacência das arestas da árvore
+    vector<set<pair<int, int>>> foraDaArvore; // Arestas fora da árvore de cada vértice: (peso, vizinho)
+    map<pair<int, int>, int> pesoForaDaArvore; // Aresta fora da árvore (menor, maior) -> peso
+    vector<int> marca;                // Marcas temporárias para a busca de substituta
+    int carimbo;                      // Valor atual das marcas
+    int custo;                        // Custo total da árvore
+
+    // Chave canônica de uma aresta não direcionada
+    static pair<int, int> chave(int v1, int v2)
+    {
+        return v1 < v2 ? make_pair(v1, v2) : make_pair(v2, v1);
+    }
+
+    // Remove w da lista de adjacência da árvore de v
+    void removeAdjArvore(int v, int w)
+    {
+        for (size_t i = 0; i < adjArvore[v].size(); i++)
+        {
+            if (adjArvore[v][i] == w)
+            {
+                adjArvore[v][i] = adjArvore[v].back();
+                adjArvore[v].pop_back();
+                return;
+            }
+        }
+    }
+
+    // Adiciona a aresta à árvore
+    void ligaNaArvore(int v1, int v2, int peso)
+    {
+        int no;
+        if (!nosLivres.empty())
+        {
+            no = nosLivres.back();
+            nosLivres.pop_back();
+            floresta.reiniciaNo(no, peso);
+        }
+        else
+        {
+            no = floresta.novoNo(peso);
+            arestaDoNo.push_back(Aresta());
+        }
+
+        Aresta e;
+        e.origem = min(v1, v2);
+        e.destino = max(v1, v2);
+        e.peso = peso;
+        arestaDoNo[no - g.numVertices] = e;
+
+        floresta.conecta(v1, no);
+        floresta.conecta(no, v2);
+        noDaAresta[chave(v1, v2)] = no;
+        adjArvore[v1].push_back(v2);
+        adjArvore[v2].push_back(v1);
+        custo += peso;
+    }
+
+    // Registra uma aresta que ficou fora da árvore
+    void guardaForaDaArvore(int v1, int v2, int peso)
+    {
+        foraDaArvore[v1].insert(make_pair(peso, v2));
+        foraDaArvore[v2].insert(make_pair(peso, v1));
+        pesoForaDaArvore[chave(v1, v2)] = peso;
+    }
+
+    // Esquece uma aresta fora da árvore (removida do grafo ou promovida à árvore)
+    void descartaForaDaArvore(int v1, int v2, int peso)
+    {
+        foraDaArvore[v1].erase(make_pair(peso, v2));
+        foraDaArvore[v2].erase(make_pair(peso, v1));
+        pesoForaDaArvore.erase(chave(v1, v2));
+    }
+
+    // Retira da árvore a aresta representada pelo nó dado
+    void cortaDaArvore(int no)
+    {
+        Aresta e = arestaDoNo[no - g.numVertices];
+        floresta.corta(e.origem, no);
+        floresta.corta(no, e.destino);
+        nosLivres.push_back(no);
+        noDaAresta.erase(chave(e.origem, e.destino));
+        removeAdjArvore(e.origem, e.destino);
+        removeAdjArvore(e.destino, e.origem);
+        custo -= e.peso;
+    }
+
+    // Procura a aresta de menor peso que reconecta os lados de u e v após um corte.
+    // Percorre as duas subárvores alternadamente e examina apenas as arestas fora da
+    // árvore do lado menor, em ordem de peso, parando na primeira que cruza o corte.
+    // Custo O(V + E log V) no pior caso (corte equilibrado com arestas internas leves)
+    void reconecta(int u, int v)
+    {
+        carimbo += 2;
+        int marcaU = carimbo, marcaV = carimbo + 1;
+
+        vector<int> ladoU(1, u), ladoV(1, v);
+        marca[u] = marcaU;
+        marca[v] = marcaV;
+        size_t iU = 0, iV = 0;
+
+        // Expande um vértice de cada lado por vez até um deles terminar
+        while (iU < ladoU.size() && iV < ladoV.size())
+        {
+            int x = ladoU[iU++];
+            for (int y : adjArvore[x])
+            {
+                if (marca[y] != marcaU)
+                {
+                    marca[y] = marcaU;
+                    ladoU.push_back(y);
+                }
+            }
+
+            int w = ladoV[iV++];
+            for (int y : adjArvore[w])
+            {
+                if (marca[y] != marcaV)
+                {
+                    marca[y] = marcaV;
+                    ladoV.push_back(y);
+                }
+            }
+        }
+
+        // O lado que terminou primeiro está completo e é o menor
+        bool usaU = iU == ladoU.size();
+        vector<int> &menor = usaU ? ladoU : ladoV;
+        int marcaMenor = usaU ? marcaU : marcaV;
+
+        // Toda aresta que sai do lado menor chega ao outro lado da mesma componente.
+        // Como cada conjunto está em ordem de peso, basta a primeira que cruza o corte
+        int melhorX = -1, melhorY = -1, melhorPeso = 0;
+        for (int x : menor)
+        {
+            for (auto &aresta : foraDaArvore[x])
+            {
+                if (melhorX != -1 && aresta.first >= melhorPeso)
+                {
+                    break; // As demais deste vértice não melhoram a substituta
+                }
+                if (marca[aresta.second] != marcaMenor)
+                {
+                    melhorX = x;
+                    melhorY = aresta.second;
+                    melhorPeso = aresta.first;
+                    break;
+                }
+            }
+        }
+
+        if (melhorX != -1)
+        {
+            descartaForaDaArvore(melhorX, melhorY, melhorPeso);
+            ligaNaArvore(melhorX, melhorY, melhorPeso);
+        }
+    }
+
+public:
+    // Construtor - monta a árvore inicial com Kruskal
+    ArvoreGeradoraDinamica(Grafo &grafo) : g(grafo), carimbo(0), custo(0)
+    {
+        for (int i = 0; i < g.numVertices; i++)
+        {
+            floresta.novoNo(numeric_limits<int>::min()); // Vértices não têm peso
+        }
+        adjArvore.resize(g.numVertices);
+        foraDaArvore.resize(g.numVertices);
+        marca.assign(g.numVertices, 0);
+
+        vector<Aresta> arestas;
+        for (int i = 0; i < g.numVertices; i++)
+        {
+            ElemLista *atual = g.A[i];
+            while (atual != nullptr)
+            {
+                if (i < atual->vertice)
+                {
+                    arestas.push_back({i, atual->vertice, atual->peso});
+                }
+                atual = atual->prox;
+            }
+        }
+        sort(arestas.begin(), arestas.end());
+
+        DisjointSet ds(g.numVertices);
+        for (auto &aresta : arestas)
+        {
+            if (ds.find(aresta.origem) != ds.find(aresta.destino))
+            {
+                ds.unir(aresta.origem, aresta.destino);
+                ligaNaArvore(aresta.origem, aresta.destino, aresta.peso);
+            }
+            else
+            {
+                guardaForaDaArvore(aresta.origem, aresta.destino, aresta.peso);
+            }
+        }
+    }
+
+    // Adiciona aresta ao grafo; se fechar um ciclo, substitui a aresta mais pesada do ciclo
+    bool adicionaAresta(int v1, int v2, int peso)
+    {
+        int arestasAntes = g.numArestas;
+        g.adicionaAresta(v1, v2, peso);
+        if (g.numArestas == arestasAntes)
+        {
+            return false; // Entrada inválida ou aresta já existente
+        }
+
+        int pesoEfetivo = g.ponderado ? peso : 1;
+        if (!floresta.conectados(v1, v2))
+        {
+            ligaNaArvore(v1, v2, pesoEfetivo); // Une duas componentes
+            return true;
+        }
+
+        // O maior nó do caminho é sempre um nó de aresta, pois vértices valem -infinito
+        int maisPesada = floresta.maximoCaminho(v1, v2);
+        if (floresta.valorNo(maisPesada) > pesoEfetivo)
+        {
+            Aresta substituida = arestaDoNo[maisPesada - g.numVertices];
+            cortaDaArvore(maisPesada);
+            ligaNaArvore(v1, v2, pesoEfetivo);
+            guardaForaDaArvore(substituida.origem, substituida.destino, substituida.peso);
+        }
+        else
+        {
+            guardaForaDaArvore(v1, v2, pesoEfetivo);
+        }
+        return true;
+    }
+
+    // Remove aresta do grafo; se estava na árvore, procura a melhor substituta
+    bool removeAresta(int v1, int v2)
+    {
+        if (!g.removeAresta(v1, v2))
+        {
+            return false;
+        }
+
+        map<pair<int, int>, int>::iterator it = noDaAresta.find(chave(v1, v2));
+        if (it != noDaAresta.end())
+        {
+            cortaDaArvore(it->second);
+            reconecta(v1, v2);
+        }
+        else
+        {
+            map<pair<int, int>, int>::iterator fora = pesoForaDaArvore.find(chave(v1, v2));
+            if (fora != pesoForaDaArvore.end())
+            {
+                descartaForaDaArvore(v1, v2, fora->second);
+            }
+        }
+        return true;
+    }
+
+    // Retorna as arestas que compõem a árvore atual
+    vector<Aresta> arestas() const
+    {
+        vector<Aresta> resultado;
+        for (auto &par : noDaAresta)
+        {
+            resultado.push_back(arestaDoNo[par.second - g.numVertices]);
+        }
+        return resultado;
+    }
+
+    // Retorna o custo total da árvore atual
+    int custoTotal() const
+    {
+        return custo;
+    }
+
+    // Exibe a árvore atual no mesmo formato de Kruskal e Prim
+    void exibe() const
+    {
+        cout << "\nArvore Geradora Minima (dinamica):\n";
+        cout << "Arestas na MST:\n";
+        for (auto &aresta : arestas())
+        {
+            cout << aresta.origem << " -- " << aresta.destino << " (peso: " << aresta.peso << ")\n";
+        }
+        cout << "Custo total da MST: " << custo << endl;
+    }
+};
+
+// Vizinho em uma linha de adjacência imutável (usada pelas versões do grafo)
+struct Vizinho
+{
+    int vertice; // Vértice de destino da aresta
+    int peso;    // Peso/custo da aresta
+
+    // Ordena vizinhos pelo vértice de destino
+    bool operator<(const Vizinho &outro) const
+    {
+        return vertice < outro.vertice;
+    }
+};
+
+// Versão imutável de um grafo. Cada linha de adjacência é compartilhada entre
+// as versões que não a alteraram (cópia na escrita por linha)
+struct VersaoGrafo
+{
+    unsigned long long numero; // Número sequencial da versão
+    int numVertices;           // Número de vértices do grafo
+    int numArestas;            // Número de arestas do grafo
+    bool direcionado;          // Define se o grafo é direcionado
+    vector<shared_ptr<const vector<Vizinho>>> linhas; // Linhas de adjacência ordenadas por vértice
+
+    // Percorre os vizinhos de u chamando f(vizinho, peso) para cada aresta
+    template <typename Funcao>
+    void paraCadaVizinho(int u, Funcao f) const
+    {
+        for (const Vizinho &viz : *linhas[u])
+        {
+            f(viz.vertice, viz.peso);
+        }
+    }
+
+    // Calcula distâncias em número de arestas a partir de v (BFS).
+    // O resultado lê a área de trabalho da thread: vale até a próxima consulta nela
+    DistanciasConsulta distanciasBFS(int v) const
+    {
+        EspacoTrabalho &ws = EspacoTrabalho::daThread();
+        buscaLargura(*this, v, ws);
+        return DistanciasConsulta(ws);
+    }
+
+    // Calcula distâncias ponderadas a partir de v (Dijkstra com heap binário).
+    // O resultado lê a área de trabalho da thread: vale até a próxima consulta nela
+    DistanciasConsulta distanciasDijkstra(int v) const
+    {
+        EspacoTrabalho &ws = EspacoTrabalho::daThread();
+        caminhosMinimos(*this, v, ws);
+        return DistanciasConsulta(ws);
+    }
+};
+
+// Grafo com versões publicadas atomicamente para muitos leitores e um escritor.
+// O escritor monta uma nova versão copiando apenas as linhas alteradas e a publica
+// com uma troca atômica; os leitores fixam uma época e consultam sem travas.
+// Versões substituídas só são liberadas quando nenhum leitor fixado pode enxergá-las
+// (reciclagem baseada em épocas)
+class GrafoVersionado
+{
+public:
+    // Guarda de leitura: fixa uma época e dá acesso a uma versão estável do grafo
+    class Leitura
+    {
+    private:
+        GrafoVersionado &grafo;
+        int slot;                 // Posição ocupada na tabela de leitores
+        const VersaoGrafo *versao; // Versão enxergada durante toda a leitura
+
+    public:
+        Leitura(GrafoVersionado &g) : grafo(g)
+        {
+            slot = grafo.ocupaSlot();
+
+            // Publica a época fixada e confirma que ela ainda é a atual
+            unsigned long long epoca = grafo.epocaGlobal.load();
+            while (true)
+            {
+                grafo.epocaLeitor[slot].store(epoca);
+                unsigned long long confirmada = grafo.epocaGlobal.load();
+                if (confirmada == epoca)
+                    break;
+                epoca = confirmada;
+            }
+            versao = grafo.atual.load();
+        }
+
+        ~Leitura()
+        {
+            grafo.epocaLeitor[slot].store(0);
+            grafo.slotOcupado[slot].store(false);
+        }
+
+        const VersaoGrafo &operator*() const
+        {
+            return *versao;
+        }
+
+        const VersaoGrafo *operator->() const
+        {
+            return versao;
+        }
+    };
+
+private:
+    static const int MAX_LEITORES = 64; // Leitores simultâneos suportados
+
+    atomic<VersaoGrafo *> atual;                       // Versão publicada
+    atomic<unsigned long long> epocaGlobal;            // Época atual (começa em 1)
+    atomic<unsigned long long> epocaLeitor[MAX_LEITORES]; // Época fixada por leitor (0 = nenhuma)
+    atomic<bool> slotOcupado[MAX_LEITORES];            // Posições da tabela em uso
+    mutex escrita;                                     // Serializa os escritores
+    vector<pair<VersaoGrafo *, unsigned long long>> aposentadas; // Versões aguardando liberação
+    unsigned long long recicladas;                     // Total de versões já liberadas
+
+    // Ocupa uma posição livre na tabela de leitores
+    int ocupaSlot()
+    {
+        while (true)
+        {
+            for (int i = 0; i < MAX_LEITORES; i++)
+            {
+                bool livre = false;
+                if (!slotOcupado[i].load() && slotOcupado[i].compare_exchange_strong(livre, true))
+                {
+                    return i;
+                }
+            }
+            this_thread::yield(); // Todas ocupadas - aguarda algum leitor terminar
+        }
+    }
+
+    // Publica uma nova versão e aposenta a anterior
+    void publica(VersaoGrafo *nova)
+    {
+        VersaoGrafo *antiga = atual.exchange(nova);
+        unsigned long long epoca = epocaGlobal.fetch_add(1);
+        aposentadas.push_back(make_pair(antiga, epoca));
+        recicla();
+    }
+
+    // Libera as versões aposentadas antes da menor época fixada por algum leitor
+    void recicla()
+    {
+        unsigned long long menor = numeric_limits<unsigned long long>::max();
+        for (int i = 0; i < MAX_LEITORES; i++)
+        {
+            unsigned long long e = epocaLeitor[i].load();
+            if (e != 0 && e < menor)
+                menor = e;
+        }
+
+        size_t mantidas = 0;
+        for (size_t i = 0; i < aposentadas.size(); i++)
+        {
+            if (aposentadas[i].second < menor)
+            {
+                delete aposentadas[i].first;
+                recicladas++;
+            }
+            else
+            {
+                aposentadas[mantidas++] = aposentadas[i];
+            }
+        }
+        aposentadas.resize(mantidas);
+    }
+
+    // Valida os vértices de uma aresta
+    bool entradaValida(const VersaoGrafo &v, int v1, int v2) const
+    {
+        return !(v1 < 0 || v2 < 0 || v1 >= v.numVertices || v2 >= v.numVertices || v1 == v2);
+    }
+
+    // Cria uma cópia de linha com o vizinho inserido na posição ordenada
+    static shared_ptr<const vector<Vizinho>> linhaComInsercao(const vector<Vizinho> &linha, int v, int peso)
+    {
+        shared_ptr<vector<Vizinho>> nova = make_shared<vector<Vizinho>>();
+        nova->reserve(linha.size() + 1);
+        Vizinho novo = {v, peso};
+        vector<Vizinho>::const_iterator pos = lower_bound(linha.begin(), linha.end(), novo);
+        nova->insert(nova->end(), linha.begin(), pos);
+        nova->push_back(novo);
+        nova->insert(nova->end(), pos, linha.end());
+        return nova;
+    }
+
+    // Cria uma cópia de linha sem o vizinho v
+    static shared_ptr<const vector<Vizinho>> linhaComRemocao(const vector<Vizinho> &linha, int v)
+    {
+        shared_ptr<vector<Vizinho>> nova = make_shared<vector<Vizinho>>();
+        nova->reserve(linha.size());
+        for (const Vizinho &viz : linha)
+        {
+            if (viz.vertice != v)
+                nova->push_back(viz);
+        }
+        return nova;
+    }
+
+    // Procura o vizinho v em uma linha ordenada
+    static bool contem(const vector<Vizinho> &linha, int v)
+    {
+        Vizinho alvo = {v, 0};
+        return binary_search(linha.begin(), linha.end(), alvo);
+    }
+
+public:
+    // Construtor - cria a primeira versão a partir de um grafo existente
+    GrafoVersionado(Grafo &g) : epocaGlobal(1), recicladas(0)
+    {
+        for (int i = 0; i < MAX_LEITORES; i++)
+        {
+            epocaLeitor[i].store(0);
+            slotOcupado[i].store(false);
+        }
+
+        VersaoGrafo *inicial = new VersaoGrafo();
+        inicial->numero = 1;
+        inicial->numVertices = g.numVertices;
+        inicial->numArestas = g.numArestas;
+        inicial->direcionado = g.direcionado;
+        for (int i = 0; i < g.numVertices; i++)
+        {
+            shared_ptr<vector<Vizinho>> linha = make_shared<vector<Vizinho>>();
+            ElemLista *atualElem = g.A[i];
+            while (atualElem != nullptr)
+            {
+                Vizinho viz = {atualElem->vertice, atualElem->peso};
+                linha->push_back(viz);
+                atualElem = atualElem->prox;
+            }
+            inicial->linhas.push_back(linha);
+        }
+        atual.store(inicial);
+    }
+
+    // Destrutor - não pode haver leitores ativos
+    ~GrafoVersionado()
+    {
+        for (auto &a : aposentadas)
+        {
+            delete a.first;
+        }
+        delete atual.load();
+    }
+
+    // Adiciona aresta publicando uma nova versão (em ambas direções se não direcionado)
+    bool adicionaAresta(int v1, int v2, int peso)
+    {
+        lock_guard<mutex> trava(escrita);
+        const VersaoGrafo *corrente = atual.load();
+        if (!entradaValida(*corrente, v1, v2))
+        {
+            cout << "Entrada invalida" << endl;
+            return false;
+        }
+        if (contem(*corrente->linhas[v1], v2))
+        {
+            return false; // Aresta já existe
+        }
+
+        // Copia apenas a tabela de linhas; as linhas inalteradas continuam compartilhadas
+        VersaoGrafo *nova = new VersaoGrafo(*corrente);
+        nova->numero++;
+        nova->numArestas++;
+        nova->linhas[v1] = linhaComInsercao(*corrente->linhas[v1], v2, peso);
+        if (!nova->direcionado)
+        {
+            nova->linhas[v2] = linhaComInsercao(*corrente->linhas[v2], v1, peso);
+        }
+        publica(nova);
+        return true;
+    }
+
+    // Remove aresta publicando uma nova versão
+    bool removeAresta(int v1, int v2)
+    {
+        lock_guard<mutex> trava(escrita);
+        const VersaoGrafo *corrente = atual.load();
+        if (!entradaValida(*corrente, v1, v2))
+        {
+            cout << "Entrada invalida\n";
+            return false;
+        }
+        if (!contem(*corrente->linhas[v1], v2))
+        {
+            return false; // Aresta não encontrada
+        }
+
+        VersaoGrafo *nova = new VersaoGrafo(*corrente);
+        nova->numero++;
+        nova->numArestas--;
+        nova->linhas[v1] = linhaComRemocao(*corrente->linhas[v1], v2);
+        if (!nova->direcionado)
+        {
+            nova->linhas[v2] = linhaComRemocao(*corrente->linhas[v2], v1);
+        }
+        publica(nova);
+        return true;
+    }
+
+    // Número da versão publicada no momento
+    unsigned long long numeroVersao() const
+    {
+        return atual.load()->numero;
+    }
+
+    // Total de versões antigas já liberadas
+    unsigned long long versoesRecicladas()
+    {
+        lock_guard<mutex> trava(escrita);
+        return recicladas;
+    }
+};
+
+// Critérios para renumerar os vértices e aproximar vizinhos na memória
+enum OrdenacaoVertices
+{
+    ORDEM_ORIGINAL, // Mantém os identificadores de entrada
+    ORDEM_RCM,      // Reverse Cuthill-McKee: reduz a largura de banda da matriz de adjacência
+    ORDEM_GRAU,     // Grau decrescente: hubs ficam juntos no início dos vetores
+    ORDEM_BFS       // Ordem de descoberta da BFS: vizinhos recebem números próximos
+};
+
+// Grafo com vértices renumerados e os mapas entre os identificadores
+struct GrafoReordenado
+{
+    Grafo *grafo;           // Grafo com os novos identificadores (pertence a esta estrutura)
+    vector<int> novoId;     // Identificador original -> novo
+    vector<int> idOriginal; // Identificador novo -> original
+
+    GrafoReordenado() : grafo(nullptr) {}
+
+    ~GrafoReordenado()
+    {
+        delete grafo;
+    }
+
+    // O grafo pertence a uma única estrutura: uma cópia o liberaria duas vezes
+    GrafoReordenado(const GrafoReordenado &) = delete;
+    GrafoReordenado &operator=(const GrafoReordenado &) = delete;
+};
+
+// Medidas de localidade das arestas conforme a numeração dos vértices
+struct MetricasLocalidade
+{
+    int larguraBanda;        // Maior |u - v| entre vértices adjacentes
+    double distanciaMedia;   // Média de |u - v| entre vértices adjacentes
+    double fracaoProxima;    // Fração das arestas com |u - v| < 16 (mesma linha de cache de int)
+};
+
+// Calcula as medidas de localidade do grafo
+MetricasLocalidade calculaLocalidade(Grafo &g)
+{
+    MetricasLocalidade m = {0, 0.0, 0.0};
+    long long arcos = 0, proximos = 0;
+    double soma = 0;
+    for (int u = 0; u < g.numVertices; u++)
+    {
+        for (ElemLista *atual = g.A[u]; atual != nullptr; atual = atual->prox)
+        {
+            int distancia = abs(u - atual->vertice);
+            m.larguraBanda = max(m.larguraBanda, distancia);
+            soma += distancia;
+            if (distancia < 16)
+                proximos++;
+            arcos++;
+        }
+    }
+    if (arcos > 0)
+    {
+        m.distanciaMedia = soma / arcos;
+        m.fracaoProxima = (double)proximos / arcos;
+    }
+    return m;
+}
+
+// Exibe as medidas de localidade
+void exibeLocalidade(ostream &saida, const char *rotulo, const MetricasLocalidade &m)
+{
+    ios::fmtflags formato = saida.flags();
+    streamsize precisao = saida.precision();
+    saida << rotulo << ": largura de banda " << m.larguraBanda
+          << ", distancia media " << fixed << setprecision(1) << m.distanciaMedia
+          << ", arestas proximas " << m.fracaoProxima * 100 << "%\n";
+    saida.flags(formato);
+    saida.precision(precisao);
+}
+
+// Retorna o grau de cada vértice
+vector<int> grausVertices(Grafo &g)
+{
+    vector<int> grau(g.numVertices, 0);
+    for (int u = 0; u < g.numVertices; u++)
+    {
+        for (ElemLista *atual = g.A[u]; atual != nullptr; atual = atual->prox)
+        {
+            grau[u]++;
+        }
+    }
+    return grau;
+}
+
+// Calcula a sequência de vértices (originais) na nova ordem
+vector<int> calculaOrdem(Grafo &g, OrdenacaoVertices criterio)
+{
+    int n = g.numVertices;
+    vector<int> ordem;
+    ordem.reserve(n);
+
+    if (criterio == ORDEM_ORIGINAL)
+    {
+        for (int v = 0; v < n; v++)
+            ordem.push_back(v);
+        return ordem;
+    }
+
+    vector<int> grau = grausVertices(g);
+    if (criterio == ORDEM_GRAU)
+    {
+        for (int v = 0; v < n; v++)
+            ordem.push_back(v);
+        stable_sort(ordem.begin(), ordem.end(), [&](int a, int b)
+                    { return grau[a] > grau[b]; });
+        return ordem;
+    }
+
+    // RCM e BFS percorrem cada componente em largura; o RCM começa pelo vértice de
+    // menor grau, visita vizinhos em grau crescente e inverte a ordem no final
+    vector<int> candidatos;
+    for (int v = 0; v < n; v++)
+        candidatos.push_back(v);
+    if (criterio == ORDEM_RCM)
+    {
+        stable_sort(candidatos.begin(), candidatos.end(), [&](int a, int b)
+                    { return grau[a] < grau[b]; });
+    }
+
+    vector<bool> visitado(n, false);
+    vector<int> vizinhos;
+    for (int inicio : candidatos)
+    {
+        if (visitado[inicio])
+            continue;
+
+        size_t cabeca = ordem.size();
+        visitado[inicio] = true;
+        ordem.push_back(inicio);
+        while (cabeca < ordem.size())
+        {
+            int u = ordem[cabeca++];
+            vizinhos.clear();
+            for (ElemLista *atual = g.A[u]; atual != nullptr; atual = atual->prox)
+            {
+                if (!visitado[atual->vertice])
+                {
+                    visitado[atual->vertice] = true;
+                    vizinhos.push_back(atual->vertice);
+                }
+            }
+            if (criterio == ORDEM_RCM)
+            {
+                stable_sort(vizinhos.begin(), vizinhos.end(), [&](int a, int b)
+                            { return grau[a] < grau[b]; });
+            }
+            ordem.insert(ordem.end(), vizinhos.begin(), vizinhos.end());
+        }
+    }
+
+    if (criterio == ORDEM_RCM)
+        reverse(ordem.begin(), ordem.end());
+    return ordem;
+}
+
+// Cria uma cópia do grafo com os vértices renumerados conforme o critério.
+// As listas são montadas na ordem dos novos identificadores, então os nós de
+// vértices vizinhos também ficam próximos na memória
+void reordenaGrafo(Grafo &g, OrdenacaoVertices criterio, GrafoReordenado &resultado)
+{
+    int n = g.numVertices;
+    resultado.idOriginal = calculaOrdem(g, criterio);
+    resultado.novoId.assign(n, 0);
+    for (int novo = 0; novo < n; novo++)
+    {
+        resultado.novoId[resultado.idOriginal[novo]] = novo;
+    }
+
+    delete resultado.grafo;
+    resultado.grafo = new Grafo(n, g.direcionado, g.ponderado);
+    Grafo &r = *resultado.grafo;
+    r.numArestas = g.numArestas;
+
+    vector<pair<int, int>> linha; // (novo vizinho, peso)
+    for (int novo = 0; novo < n; novo++)
+    {
+        linha.clear();
+        for (ElemLista *atual = g.A[resultado.idOriginal[novo]]; atual != nullptr; atual = atual->prox)
+        {
+            linha.push_back(make_pair(resultado.novoId[atual->vertice], atual->peso));
+        }
+        sort(linha.begin(), linha.end());
+
+        // Monta a lista já ordenada, do fim para o início
+        ElemLista *lista = nullptr;
+        for (int i = (int)linha.size() - 1; i >= 0; i--)
+        {
+            ElemLista *novoElem = new ElemLista();
+            novoElem->vertice = linha[i].first;
+            novoElem->peso = linha[i].second;
+            novoElem->prox = lista;
+            lista = novoElem;
+        }
+        r.A[novo] = lista;
+    }
+    r.reconstroiIndice();
+}
+
+// Converte o nome de um critério de ordenação (original, rcm, grau ou bfs);
+// retorna false, sem alterar ordenacao, se o nome for desconhecido
+bool ordenacaoPorNome(const string &nome, OrdenacaoVertices &ordenacao)
+{
+    if (nome == "original")
+        ordenacao = ORDEM_ORIGINAL;
+    else if (nome == "rcm")
+        ordenacao = ORDEM_RCM;
+    else if (nome == "grau")
+        ordenacao = ORDEM_GRAU;
+    else if (nome == "bfs")
+        ordenacao = ORDEM_BFS;
+    else
+        return false;
+    return true;
+}
+
+// Grafo em formato CSR comprimido, somente leitura.
+// Os vizinhos de cada vértice (já ordenados) são guardados como diferenças entre
+// vizinhos consecutivos em varint (7 bits por byte); o primeiro vizinho é guardado
+// relativo ao próprio vértice em zigzag. Os pesos ficam num vetor separado e são
+// omitidos em grafos não ponderados. Os vizinhos são decodificados durante a visita,
+// então BFS, Dijkstra, Prim e Kruskal funcionam sem descomprimir o grafo
+class GrafoComprimido
+{
+private:
+    vector<unsigned char> bytes;      // Diferenças codificadas de todas as linhas
+    vector<unsigned long long> inicioBytes; // Início da linha de cada vértice em bytes (V + 1)
+    vector<unsigned> inicioArestas;   // Índice da primeira aresta de cada vértice (V + 1)
+    vector<int> pesos;                // Peso de cada aresta (vazio se não ponderado)
+
+    // Acrescenta x em varint: 7 bits por byte, bit alto indica continuação
+    static void escreveVarint(vector<unsigned char> &saida, unsigned x)
+    {
+        while (x >= 0x80)
+        {
+            saida.push_back((unsigned char)((x & 0x7F) | 0x80));
+            x >>= 7;
+        }
+        saida.push_back((unsigned char)x);
+    }
+
+    // Lê um varint e avança o ponteiro
+    static unsigned leVarint(const unsigned char *&p)
+    {
+        unsigned x = 0;
+        int deslocamento = 0;
+        while (*p & 0x80)
+        {
+            x |= (unsigned)(*p++ & 0x7F) << deslocamento;
+            deslocamento += 7;
+        }
+        x |= (unsigned)(*p++) << deslocamento;
+        return x;
+    }
+
+    // Codifica uma linha ordenada de vizinhos do vértice u
+    void codificaLinha(int u, const vector<pair<int, int>> &linha)
+    {
+        int anterior = u;
+        for (size_t k = 0; k < linha.size(); k++)
+        {
+            if (k == 0)
+            {
+                int delta = linha[k].first - u; // Pode ser negativo: zigzag
+                escreveVarint(bytes, ((unsigned)delta << 1) ^ (unsigned)(delta >> 31));
+            }
+            else
+            {
+                escreveVarint(bytes, (unsigned)(linha[k].first - anterior));
+            }
+            anterior = linha[k].first;
+            if (ponderado)
+                pesos.push_back(linha[k].second);
+        }
+        inicioBytes[u + 1] = bytes.size();
+        inicioArestas[u + 1] = inicioArestas[u] + (unsigned)linha.size();
+    }
+
+    // Prepara os vetores para n vértices
+    void reinicia(int n)
+    {
+        numVertices = n;
+        bytes.clear();
+        pesos.clear();
+        inicioBytes.assign(n + 1, 0);
+        inicioArestas.assign(n + 1, 0);
+    }
+
+public:
+    int numVertices;  // Número de vértices do grafo
+    int numArestas;   // Número de arestas do grafo
+    bool direcionado; // Define se o grafo é direcionado
+    bool ponderado;   // Define se os pesos são guardados
+
+    GrafoComprimido() : numVertices(0), numArestas(0), direcionado(false), ponderado(true) {}
+
+    // Construtor - comprime um grafo existente (as listas já estão ordenadas)
+    GrafoComprimido(Grafo &g) : numArestas(g.numArestas), direcionado(g.direcionado), ponderado(g.ponderado)
+    {
+        reinicia(g.numVertices);
+        vector<pair<int, int>> linha;
+        for (int u = 0; u < g.numVertices; u++)
+        {
+            linha.clear();
+            for (ElemLista *atual = g.A[u]; atual != nullptr; atual = atual->prox)
+            {
+                linha.push_back(make_pair(atual->vertice, atual->peso));
+            }
+            codificaLinha(u, linha);
+        }
+        bytes.shrink_to_fit();
+        pesos.shrink_to_fit();
+    }
+
+    // Carrega direto do arquivo (mesmo formato de carregaGrafo) sem montar as listas
+    // encadeadas; a memória de pico é a lista de arcos em vez dos nós de ElemLista
+    bool carrega(const char *caminho)
+    {
+        ifstream arquivo(caminho);
+        int n, m, dir, pond;
+        if (!arquivo || !(arquivo >> n >> m >> dir >> pond) || n <= 0)
+        {
+            cerr << "Nao foi possivel ler o grafo de " << caminho << endl;
+            return false;
+        }
+        direcionado = dir != 0;
+        ponderado = pond != 0;
+
+        vector<Aresta> arcos;
+        arcos.reserve(direcionado ? m : 2 * (size_t)m);
+        int v1, v2, peso;
+        for (int i = 0; i < m && arquivo >> v1 >> v2 >> peso; i++)
+        {
+            if (v1 < 0 || v2 < 0 || v1 >= n || v2 >= n || v1 == v2)
+            {
+                cerr << "Aresta invalida ignorada: " << v1 << " " << v2 << endl;
+                continue;
+            }
+            arcos.push_back({v1, v2, ponderado ? peso : 1});
+            if (!direcionado)
+                arcos.push_back({v2, v1, ponderado ? peso : 1});
+        }
+
+        // Ordena por (origem, destino); repetições mantêm a primeira ocorrência, como em adicionaAresta
+        stable_sort(arcos.begin(), arcos.end(), [](const Aresta &a, const Aresta &b)
+                    { return a.origem != b.origem ? a.origem < b.origem : a.destino < b.destino; });
+        arcos.erase(unique(arcos.begin(), arcos.end(), [](const Aresta &a, const Aresta &b)
+                           { return a.origem == b.origem && a.destino == b.destino; }),
+                    arcos.end());
+
+        reinicia(n);
+        numArestas = direcionado ? (int)arcos.size() : (int)arcos.size() / 2;
+        vector<pair<int, int>> linha;
+        size_t i = 0;
+        for (int u = 0; u < n; u++)
+        {
+            linha.clear();
+            for (; i < arcos.size() && arcos[i].origem == u; i++)
+            {
+                linha.push_back(make_pair(arcos[i].destino, arcos[i].peso));
+            }
+            codificaLinha(u, linha);
+        }
+        bytes.shrink_to_fit();
+        pesos.shrink_to_fit();
+        return true;
+    }
+
+    // Percorre os vizinhos de u decodificando as diferenças
+    template <typename Funcao>
+    void paraCadaVizinho(int u, Funcao f) const
+    {
+        const unsigned char *p = bytes.data() + inicioBytes[u];
+        unsigned primeira = inicioArestas[u], fim = inicioArestas[u + 1];
+        int v = u;
+        for (unsigned k = primeira; k < fim; k++)
+        {
+            unsigned x = leVarint(p);
+            if (k == primeira)
+                v = u + (int)((x >> 1) ^ (0u - (x & 1))); // Desfaz o zigzag
+            else
+                v += (int)x;
+            f(v, ponderado ? pesos[k] : 1);
+        }
+    }
+
+    // Grau de saída de u
+    int grau(int u) const
+    {
+        return (int)(inicioArestas[u + 1] - inicioArestas[u]);
+    }
+
+    // Memória ocupada pela estrutura, em bytes
+    size_t memoriaBytes() const
+    {
+        return bytes.capacity() + pesos.capacity() * sizeof(int) +
+               inicioBytes.capacity() * sizeof(unsigned long long) +
+               inicioArestas.capacity() * sizeof(unsigned);
+    }
+
+    // Memória estimada das listas encadeadas do Grafo com os mesmos arcos
+    // (nó de ElemLista mais o cabeçalho típico do alocador)
+    size_t memoriaListasBytes() const
+    {
+        return (size_t)inicioArestas[numVertices] * (sizeof(ElemLista) + 16) + numVertices * sizeof(ElemLista *);
+    }
+};
+
+// Grafo em memória externa: os arcos ficam no disco, em fragmentos binários
+// particionados por faixa do vértice de origem. Só vetores de O(V) ficam na memória
+// (modelo semi-externo) e os arcos são lidos em blocos sequenciais de tamanho limitado
+// Cria um diretório temporário exclusivo em $TMPDIR (%TEMP% no Windows, /tmp se não
+// definido); retorna o caminho, ou vazio se não foi possível criá-lo
+string criaDiretorioTemporario(const string &nome)
+{
+#ifdef _WIN32
+    const char *base = getenv("TEMP");
+    string raiz = base != nullptr && *base != '\0' ? base : ".";
+    for (int tentativa = 0; tentativa < 100; tentativa++)
+    {
+        string caminho = raiz + "\\" + nome + "." + to_string(_getpid()) + "." + to_string(tentativa);
+        if (_mkdir(caminho.c_str()) == 0)
+            return caminho;
+    }
+    return "";
+#else
+    const char *base = getenv("TMPDIR");
+    string modelo = string(base != nullptr && *base != '\0' ? base : "/tmp") + "/" + nome + ".XXXXXX";
+    vector<char> caminho(modelo.begin(), modelo.end());
+    caminho.push_back('\0');
+    return mkdtemp(caminho.data()) != nullptr ? string(caminho.data()) : string();
+#endif
+}
+
+// Apaga um diretório (vazio) criado por criaDiretorioTemporario
+void apagaDiretorio(const string &caminho)
+{
+#ifdef _WIN32
+    _rmdir(caminho.c_str());
+#else
+    rmdir(caminho.c_str());
+#endif
+}
+
+class GrafoExterno
+{
+private:
+    string diretorio;            // Diretório temporário exclusivo desta instância (vazio se não foi criado)
+    vector<string> fragmentos;   // Arquivo de cada fragmento
+    int verticesPorFragmento;    // Faixa de vértices de origem de cada fragmento
+    size_t registrosBloco;       // Arcos em memória por vez (limite de memória)
+    vector<Aresta> bloco;        // Bloco de leitura reutilizado
+
+    // Fragmento que guarda os arcos que saem de u
+    int fragmentoDe(int u) const
+    {
+        return u / verticesPorFragmento;
+    }
+
+    // Grava os arcos do buffer no final do arquivo e esvazia o buffer.
+    // Retorna false se nem todos foram gravados (disco cheio, erro de E/S)
+    static bool despeja(FILE *arquivo, vector<Aresta> &buffer)
+    {
+        bool gravou = buffer.empty() || fwrite(buffer.data(), sizeof(Aresta), buffer.size(), arquivo) == buffer.size();
+        buffer.clear();
+        return gravou;
+    }
+
+    // Fecha um arquivo gravado; avisa e retorna false se a gravação falhou
+    static bool fechaGravado(FILE *arquivo, const string &caminho, bool gravou)
+    {
+        if (fclose(arquivo) != 0)
+            gravou = false;
+        if (!gravou)
+            cerr << "Erro ao gravar " << caminho << endl;
+        return gravou;
+    }
+
+    // Lê o arquivo de arcos do início ao fim, um bloco por vez, chamando f para cada arco.
+    // Retorna false se o arquivo não puder ser aberto ou lido
+    template <typename Funcao>
+    bool percorreArquivo(const string &caminho, Funcao f)
+    {
+        FILE *arquivo = fopen(caminho.c_str(), "rb");
+        if (arquivo == nullptr)
+        {
+            cerr << "Nao foi possivel abrir " << caminho << endl;
+            return false;
+        }
+        bloco.resize(registrosBloco);
+        size_t lidos;
+        while ((lidos = fread(bloco.data(), sizeof(Aresta), bloco.size(), arquivo)) > 0)
+        {
+            passagens.bytesLidos += (long long)(lidos * sizeof(Aresta));
+            for (size_t i = 0; i < lidos; i++)
+            {
+                f(bloco[i]);
+            }
+        }
+        bool leu = !ferror(arquivo);
+        fclose(arquivo);
+        if (!leu)
+            cerr << "Erro ao ler " << caminho << endl;
+        return leu;
+    }
+
+    // Leitor sequencial de uma corrida ordenada durante a intercalação
+    struct LeitorCorrida
+    {
+        FILE *arquivo;
+        vector<Aresta> buffer;
+        size_t posicao, quantidade;
+
+        // Avança para o próximo arco; retorna false no fim da corrida (ou em erro de leitura)
+        bool avanca(long long &bytesLidos)
+        {
+            if (++posicao < quantidade)
+                return true;
+            quantidade = fread(buffer.data(), sizeof(Aresta), buffer.size(), arquivo);
+            bytesLidos += (long long)(quantidade * sizeof(Aresta));
+            posicao = 0;
+            return quantidade > 0;
+        }
+
+        const Aresta &atual() const
+        {
+            return buffer[posicao];
+        }
+    };
+
+    // Intercala corridas ordenadas por peso chamando f em ordem crescente.
+    // Cada corrida recebe uma fatia do orçamento de memória como buffer de leitura.
+    // As corridas são apagadas ao final; retorna false se alguma não puder ser aberta
+    // (antes de chamar f) ou lida até o fim, pois a AGM sairia sem as arestas dela
+    template <typename Funcao>
+    bool intercalaCorridas(const vector<string> &corridas, Funcao f)
+    {
+        size_t porCorrida = max((size_t)1, registrosBloco / (corridas.size() + 1));
+        vector<LeitorCorrida> leitores(corridas.size());
+        typedef pair<int, int> Entrada; // (peso, corrida)
+        priority_queue<Entrada, vector<Entrada>, greater<Entrada>> heap;
+        bool sucesso = true;
+
+        for (size_t i = 0; i < corridas.size(); i++)
+        {
+            leitores[i].arquivo = fopen(corridas[i].c_str(), "rb");
+            if (leitores[i].arquivo == nullptr)
+            {
+                cerr << "Nao foi possivel abrir " << corridas[i] << endl;
+                sucesso = false;
+            }
+        }
+
+        for (size_t i = 0; sucesso && i < corridas.size(); i++)
+        {
+            leitores[i].buffer.resize(porCorrida);
+            leitores[i].posicao = leitores[i].quantidade = 0;
+            if (leitores[i].avanca(passagens.bytesLidos))
+                heap.push(make_pair(leitores[i].atual().peso, (int)i));
+        }
+
+        while (!heap.empty())
+        {
+            int i = heap.top().second;
+            heap.pop();
+            f(leitores[i].atual());
+            if (leitores[i].avanca(passagens.bytesLidos))
+                heap.push(make_pair(leitores[i].atual().peso, i));
+        }
+
+        for (size_t i = 0; i < leitores.size(); i++)
+        {
+            if (leitores[i].arquivo != nullptr)
+            {
+                if (ferror(leitores[i].arquivo))
+                {
+                    cerr << "Erro ao ler " << corridas[i] << endl;
+                    sucesso = false;
+                }
+                fclose(leitores[i].arquivo);
+            }
+            remove(corridas[i].c_str());
+        }
+        return sucesso;
+    }
+
+    // Apaga os arquivos temporários ainda listados
+    static void apagaArquivos(const vector<string> &arquivos)
+    {
+        for (size_t i = 0; i < arquivos.size(); i++)
+        {
+            remove(arquivos[i].c_str());
+        }
+    }
+
+public:
+    // Máximo de corridas intercaladas de uma vez na ordenação externa
+    static const int MAX_CORRIDAS_INTERCALADAS = 64;
+
+    int numVertices;        // Número de vértices do grafo
+    long long numArestas;   // Número de arestas lidas do arquivo
+    bool direcionado;       // Define se o grafo é direcionado
+    bool ponderado;         // Define se os pesos são guardados
+
+    // Volume de E/S de um algoritmo
+    struct VolumeES
+    {
+        int varreduras;       // Fragmentos lidos por inteiro
+        long long bytesLidos; // Bytes lidos do disco
+    };
+    VolumeES passagens; // Volume de E/S do último algoritmo executado
+
+    // Construtor - memória máxima para blocos de arcos. Fragmentos e corridas ficam em um
+    // diretório temporário exclusivo: execuções simultâneas sobre o mesmo arquivo não se
+    // sobrescrevem e o diretório da entrada pode ser somente leitura
+    GrafoExterno(size_t memoriaBytes, int numFragmentos = 16)
+        : verticesPorFragmento(1), numVertices(0), numArestas(0), direcionado(false), ponderado(true)
+    {
+        registrosBloco = max((size_t)1024, memoriaBytes / sizeof(Aresta));
+        passagens.varreduras = 0;
+        passagens.bytesLidos = 0;
+
+        diretorio = criaDiretorioTemporario("trabalho_grafo");
+        if (diretorio.empty())
+        {
+            cerr << "Nao foi possivel criar diretorio temporario\n";
+            return;
+        }
+
+        fragmentos.resize(max(1, numFragmentos));
+        for (size_t f = 0; f < fragmentos.size(); f++)
+        {
+            fragmentos[f] = diretorio + "/frag" + to_string(f);
+        }
+    }
+
+    // Destrutor - apaga os fragmentos e o diretório temporário
+    ~GrafoExterno()
+    {
+        apagaArquivos(fragmentos);
+        if (!diretorio.empty())
+            apagaDiretorio(diretorio);
+    }
+
+    // O diretório temporário pertence a uma única instância
+    GrafoExterno(const GrafoExterno &) = delete;
+    GrafoExterno &operator=(const GrafoExterno &) = delete;
+
+    // Lê o arquivo texto (mesmo formato de carregaGrafo) distribuindo os arcos pelos
+    // fragmentos; em grafos não direcionados cada aresta é gravada nos dois sentidos.
+    // Arestas repetidas não são eliminadas: não alteram BFS nem componentes, e na AGM
+    // vale a de menor peso (o Grafo em memória guarda a primeira ocorrência).
+    // Retorna false se o arquivo não puder ser lido ou um fragmento não puder ser gravado
+    bool carrega(const char *caminho)
+    {
+        if (diretorio.empty())
+            return false;
+        ifstream arquivo(caminho);
+        int n, dir, pond;
+        long long m;
+        if (!arquivo || !(arquivo >> n >> m >> dir >> pond) || n <= 0)
+        {
+            cerr << "Nao foi possivel ler o grafo de " << caminho << endl;
+            return false;
+        }
+        numVertices = n;
+        direcionado = dir != 0;
+        ponderado = pond != 0;
+        numArestas = 0;
+
+        // Fragmentos mais numerosos que os vértices ficariam vazios
+        if ((int)fragmentos.size() > n)
+            fragmentos.resize(n);
+        verticesPorFragmento = (n + (int)fragmentos.size() - 1) / (int)fragmentos.size();
+
+        // Um buffer de escrita por fragmento, dividindo o orçamento de memória
+        size_t porFragmento = max((size_t)1, registrosBloco / fragmentos.size());
+        vector<FILE *> saidas(fragmentos.size());
+        vector<vector<Aresta>> buffers(fragmentos.size());
+        vector<char> gravou(fragmentos.size(), 1);
+        for (size_t f = 0; f < fragmentos.size(); f++)
+        {
+            saidas[f] = fopen(fragmentos[f].c_str(), "wb");
+            if (saidas[f] == nullptr)
+            {
+                cerr << "Nao foi possivel criar " << fragmentos[f] << endl;
+                for (size_t g = 0; g < f; g++)
+                    fclose(saidas[g]);
+                return false;
+            }
+            buffers[f].reserve(porFragmento);
+        }
+
+        int v1, v2, peso;
+        for (long long i = 0; i < m && arquivo >> v1 >> v2 >> peso; i++)
+        {
+            if (v1 < 0 || v2 < 0 || v1 >= n || v2 >= n || v1 == v2)
+            {
+                cerr << "Aresta invalida ignorada: " << v1 << " " << v2 << endl;
+                continue;
+            }
+            Aresta a = {v1, v2, ponderado ? peso : 1};
+            for (int sentido = 0; sentido < (direcionado ? 1 : 2); sentido++)
+            {
+                int f = fragmentoDe(a.origem);
+                buffers[f].push_back(a);
+                if (buffers[f].size() >= porFragmento && !despeja(saidas[f], buffers[f]))
+                    gravou[f] = 0;
+                swap(a.origem, a.destino);
+            }
+            numArestas++;
+        }
+
+        bool sucesso = true;
+        for (size_t f = 0; f < fragmentos.size(); f++)
+        {
+            if (!despeja(saidas[f], buffers[f]))
+                gravou[f] = 0;
+            if (!fechaGravado(saidas[f], fragmentos[f], gravou[f] != 0))
+                sucesso = false;
+        }
+        return sucesso;
+    }
+
+    // BFS semi-externa: as distâncias ficam na memória e cada nível varre só os
+    // fragmentos que contêm vértices da fronteira. dist[v] = -1 se v não foi alcançado.
+    // Retorna o número de níveis (0 se a origem for inválida, -1 em erro de leitura)
+    int buscaLargura(int origem, vector<int> &dist)
+    {
+        passagens.varreduras = 0;
+        passagens.bytesLidos = 0;
+        dist.assign(numVertices, -1);
+        if (origem < 0 || origem >= numVertices)
+            return 0;
+        dist[origem] = 0;
+
+        vector<char> ativo(fragmentos.size(), 0), proximo(fragmentos.size(), 0);
+        ativo[fragmentoDe(origem)] = 1;
+        int nivel = 0;
+        bool cresceu = true;
+        while (cresceu)
+        {
+            cresceu = false;
+            fill(proximo.begin(), proximo.end(), 0);
+            for (size_t f = 0; f < fragmentos.size(); f++)
+            {
+                if (!ativo[f])
+                    continue;
+                passagens.varreduras++;
+                bool leu = percorreArquivo(fragmentos[f], [&](const Aresta &a)
+                                           {
+                    if (dist[a.origem] == nivel && dist[a.destino] == -1)
+                    {
+                        dist[a.destino] = nivel + 1;
+                        proximo[fragmentoDe(a.destino)] = 1;
+                        cresceu = true;
+                    } });
+                if (!leu)
+                    return -1;
+            }
+            ativo.swap(proximo);
+            nivel++;
+        }
+        return nivel;
+    }
+
+    // Componentes conexas (fracamente conexas se direcionado) em uma única varredura:
+    // o Union-Find de O(V) fica na memória e os arcos passam uma vez em sequência.
+    // componente[v] recebe o rótulo 0..k-1 na ordem do menor vértice; retorna k
+    // (ou -1 em erro de leitura)
+    int componentesConexas(vector<int> &componente)
+    {
+        passagens.varreduras = 0;
+        passagens.bytesLidos = 0;
+        DisjointSet ds(numVertices);
+        for (size_t f = 0; f < fragmentos.size(); f++)
+        {
+            passagens.varreduras++;
+            if (!percorreArquivo(fragmentos[f], [&](const Aresta &a)
+                                 { ds.unir(a.origem, a.destino); }))
+                return -1;
+        }
+
+        componente.assign(numVertices, -1);
+        int total = 0;
+        for (int v = 0; v < numVertices; v++)
+        {
+            int raiz = ds.find(v);
+            if (componente[raiz] == -1)
+                componente[raiz] = total++;
+            componente[v] = componente[raiz];
+        }
+        return total;
+    }
+
+    // Kruskal com ordenação externa: as arestas (origem < destino) são ordenadas por
+    // peso em corridas do tamanho do bloco, gravadas no disco e intercaladas;
+    // cada aresta da floresta geradora mínima é entregue a f. Retorna o custo total,
+    // ou -1 se um arquivo temporário não puder ser criado, gravado ou lido (as arestas
+    // já entregues a f não formam então a floresta completa)
+    template <typename Funcao>
+    long long arvoreKruskal(Funcao f)
+    {
+        passagens.varreduras = 0;
+        passagens.bytesLidos = 0;
+        vector<string> corridas;
+        int proximaCorrida = 0;
+
+        // Fase 1 usa um único buffer do tamanho do orçamento: os arcos são lidos direto
+        // no fim da corrida em formação e compactados, sem um bloco de leitura à parte
+        vector<Aresta>().swap(bloco);
+        vector<Aresta> corrida(registrosBloco);
+        size_t usados = 0;
+
+        // Grava a corrida atual ordenada no disco
+        auto gravaCorrida = [&]() -> bool
+        {
+            if (usados == 0)
+                return true;
+            sort(corrida.begin(), corrida.begin() + usados);
+            corridas.push_back(diretorio + "/corrida" + to_string(proximaCorrida++));
+            FILE *saida = fopen(corridas.back().c_str(), "wb");
+            if (saida == nullptr)
+            {
+                cerr << "Nao foi possivel criar " << corridas.back() << endl;
+                return false;
+            }
+            bool gravou = fwrite(corrida.data(), sizeof(Aresta), usados, saida) == usados;
+            usados = 0;
+            return fechaGravado(saida, corridas.back(), gravou);
+        };
+
+        // Fase 1: corridas ordenadas de tamanho limitado
+        bool sucesso = true;
+        for (size_t fr = 0; sucesso && fr < fragmentos.size(); fr++)
+        {
+            passagens.varreduras++;
+            FILE *arquivo = fopen(fragmentos[fr].c_str(), "rb");
+            if (arquivo == nullptr)
+            {
+                cerr << "Nao foi possivel abrir " << fragmentos[fr] << endl;
+                sucesso = false;
+                break;
+            }
+            size_t lidos;
+            while (sucesso && (lidos = fread(corrida.data() + usados, sizeof(Aresta), registrosBloco - usados, arquivo)) > 0)
+            {
+                passagens.bytesLidos += (long long)(lidos * sizeof(Aresta));
+                size_t fim = usados + lidos;
+                for (size_t i = usados; i < fim; i++)
+                {
+                    if (corrida[i].origem < corrida[i].destino)
+                        corrida[usados++] = corrida[i];
+                }
+                if (usados == registrosBloco)
+                    sucesso = gravaCorrida();
+            }
+            if (ferror(arquivo))
+            {
+                cerr << "Erro ao ler " << fragmentos[fr] << endl;
+                sucesso = false;
+            }
+            fclose(arquivo);
+        }
+        if (sucesso)
+            sucesso = gravaCorrida();
+        vector<Aresta>().swap(corrida);
+        if (!sucesso)
+        {
+            apagaArquivos(corridas);
+            return -1;
+        }
+
+        // Fase 2: intercala em grupos até restarem poucas corridas
+        while (corridas.size() > (size_t)MAX_CORRIDAS_INTERCALADAS)
+        {
+            vector<string> proximas;
+            for (size_t i = 0; i < corridas.size(); i += MAX_CORRIDAS_INTERCALADAS)
+            {
+                vector<string> grupo(corridas.begin() + i,
+                                     corridas.begin() + min(corridas.size(), i + MAX_CORRIDAS_INTERCALADAS));
+                proximas.push_back(diretorio + "/corrida" + to_string(proximaCorrida++));
+                FILE *saida = fopen(proximas.back().c_str(), "wb");
+                if (saida == nullptr)
+                {
+                    cerr << "Nao foi possivel criar " << proximas.back() << endl;
+                    proximas.pop_back();
+                    apagaArquivos(corridas);
+                    apagaArquivos(proximas);
+                    return -1;
+                }
+                vector<Aresta> buffer;
+                buffer.reserve(max((size_t)1, registrosBloco / (MAX_CORRIDAS_INTERCALADAS + 1)));
+                bool gravou = true;
+                bool leu = intercalaCorridas(grupo, [&](const Aresta &a)
+                                             {
+                    buffer.push_back(a);
+                    if (buffer.size() == buffer.capacity() && !despeja(saida, buffer))
+                        gravou = false; });
+                if (!despeja(saida, buffer))
+                    gravou = false;
+                if (!fechaGravado(saida, proximas.back(), gravou) || !leu)
+                {
+                    apagaArquivos(corridas);
+                    apagaArquivos(proximas);
+                    return -1;
+                }
+            }
+            corridas.swap(proximas);
+        }
+
+        // Fase 3: última intercalação alimenta o Union-Find em ordem crescente de peso
+        DisjointSet ds(numVertices);
+        long long custoTotal = 0;
+        bool leu = intercalaCorridas(corridas, [&](const Aresta &a)
+                                     {
+            if (ds.find(a.origem) != ds.find(a.destino))
+            {
+                ds.unir(a.origem, a.destino);
+                custoTotal += a.peso;
+                f(a);
+            } });
+        return leu ? custoTotal : -1;
+    }
+};
+
+// Esboço count-min: estima contagens por chave em memória fixa (profundidade × largura).
+// A estimativa nunca fica abaixo do valor real e o excesso é pequeno com alta
+// probabilidade; aceita decrementos enquanto nenhuma contagem real ficar negativa
+class EsbocoContagem
+{
+private:
+    int largura, profundidade;       // Colunas e linhas da tabela
+    vector<long long> contadores;    // Tabela linha a linha
+
+    // Coluna da chave na linha dada (splitmix64 com semente por linha)
+    size_t coluna(int linha, int chave) const
+    {
+        unsigned long long x = (unsigned long long)(unsigned)chave + 0x9e3779b97f4a7c15ULL * (linha + 1);
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return (size_t)linha * largura + (size_t)(x % (unsigned long long)largura);
+    }
+
+public:
+    EsbocoContagem(int largura = 2048, int profundidade = 4)
+        : largura(largura), profundidade(profundidade), contadores((size_t)largura * profundidade, 0) {}
+
+    // Esboço cuja estimativa excede a real em no máximo epsilon * (total contado) com
+    // probabilidade 1 - delta: ceil(e / epsilon) colunas e ceil(ln(1 / delta)) linhas.
+    // O tamanho não depende do número de chaves
+    static EsbocoContagem comErro(double epsilon, double delta)
+    {
+        return EsbocoContagem((int)ceil(exp(1.0) / epsilon), (int)ceil(log(1.0 / delta)));
+    }
+
+    // Soma delta à contagem da chave
+    void incrementa(int chave, long long delta = 1)
+    {
+        for (int i = 0; i < profundidade; i++)
+        {
+            contadores[coluna(i, chave)] += delta;
+        }
+    }
+
+    // Estimativa da contagem da chave (mínimo entre as linhas)
+    long long estimativa(int chave) const
+    {
+        long long menor = numeric_limits<long long>::max();
+        for (int i = 0; i < profundidade; i++)
+        {
+            menor = min(menor, contadores[coluna(i, chave)]);
+        }
+        return menor;
+    }
+};
+
+// Aresta recebida do fluxo com o instante de chegada
+struct EventoAresta
+{
+    int origem;        // Vértice de origem
+    int destino;       // Vértice de destino
+    int peso;          // Peso da aresta
+    long long instante; // Instante em que a aresta foi observada
+};
+
+// Ingestão de arestas em fluxo: os eventos são acumulados em lotes aplicados de uma
+// vez ao grafo, e a cada lote a conectividade (Union-Find) e a atividade estimada de
+// cada vértice (esboço count-min) são atualizadas. Com janela > 0, arestas cuja última
+// chegada ficou mais de janela unidades atrás do instante mais recente expiram
+class IngestaoFluxo
+{
+private:
+    Grafo &g;                   // Grafo que recebe as arestas
+    size_t tamanhoLote;         // Eventos acumulados antes de aplicar
+    long long janela;           // Duração da janela de tempo (0 = sem expiração)
+    vector<EventoAresta> pendentes; // Eventos do lote atual
+    DisjointSet conexidade;     // Componentes do grafo após o último lote
+    EsbocoContagem chegadas;    // Chegadas de arestas por vértice (na janela, se houver)
+    enum { MAX_CANDIDATOS = 16 }; // Vértices acompanhados como candidatos a mais ativo
+    vector<pair<long long, int>> candidatos; // Vértices mais ativos acompanhados: (chegadas estimadas, vértice)
+    deque<EventoAresta> naJanela; // Eventos aplicados, em ordem de chegada
+    unordered_map<unsigned long long, long long> ultimaChegada; // Última chegada de cada aresta na janela
+
+    // Chave da aresta (sem sentido em grafo não direcionado)
+    unsigned long long chave(int u, int v) const
+    {
+        if (!g.direcionado && u > v)
+            swap(u, v);
+        return ((unsigned long long)(unsigned)u << 32) | (unsigned)v;
+    }
+
+    // Une os extremos da aresta e atualiza o número de componentes
+    void conecta(int u, int v)
+    {
+        if (conexidade.find(u) != conexidade.find(v))
+        {
+            conexidade.unir(u, v);
+            componentes--;
+        }
+    }
+
+    // Recalcula o Union-Find a partir do grafo (necessário após remoções)
+    void reconstroiConexidade()
+    {
+        conexidade = DisjointSet(g.numVertices);
+        componentes = g.numVertices;
+        for (int u = 0; u < g.numVertices; u++)
+        {
+            g.paraCadaVizinho(u, [&](int v, int)
+                              {
+                if (g.direcionado || u < v)
+                    conecta(u, v); });
+        }
+    }
+
+    // Atualiza v entre os candidatos a mais ativo após uma chegada; se os candidatos
+    // estiverem cheios, v só entra no lugar do menos ativo se o superar
+    void acompanhaCandidato(int v)
+    {
+        long long estimado = chegadas.estimativa(v);
+        size_t menor = 0, i = 0;
+        for (; i < candidatos.size() && candidatos[i].second != v; i++)
+        {
+            if (candidatos[i].first < candidatos[menor].first)
+                menor = i;
+        }
+
+        if (i < candidatos.size())
+            candidatos[i].first = estimado;
+        else if (candidatos.size() < MAX_CANDIDATOS)
+            candidatos.push_back(make_pair(estimado, v));
+        else if (estimado > candidatos[menor].first)
+            candidatos[menor] = make_pair(estimado, v);
+        else
+            return;
+
+        if (estimado > chegadasMaisAtivo)
+        {
+            maisAtivo = v;
+            chegadasMaisAtivo = estimado;
+        }
+    }
+
+    // Reavalia os candidatos depois que chegadas expiraram: o antigo líder pode ter
+    // sido ultrapassado, e candidatos sem chegadas na janela liberam o lugar
+    void reavaliaCandidatos()
+    {
+        maisAtivo = -1;
+        chegadasMaisAtivo = 0;
+        size_t mantidos = 0;
+        for (size_t i = 0; i < candidatos.size(); i++)
+        {
+            long long estimado = chegadas.estimativa(candidatos[i].second);
+            if (estimado <= 0)
+                continue;
+            candidatos[mantidos++] = make_pair(estimado, candidatos[i].second);
+            if (estimado > chegadasMaisAtivo)
+            {
+                maisAtivo = candidatos[i].second;
+                chegadasMaisAtivo = estimado;
+            }
+        }
+        candidatos.resize(mantidos);
+    }
+
+    // Conta a chegada nos dois extremos e acompanha o vértice mais ativo
+    void registraChegada(const EventoAresta &e, long long delta)
+    {
+        chegadas.incrementa(e.origem, delta);
+        chegadas.incrementa(e.destino, delta);
+        if (delta > 0)
+        {
+            acompanhaCandidato(e.origem);
+            acompanhaCandidato(e.destino);
+        }
+    }
+
+    // Remove as arestas que saíram da janela; retorna quantas foram removidas
+    int expira()
+    {
+        long long limite = agora - janela;
+        vector<pair<int, int>> expiradas;
+        while (!naJanela.empty() && naJanela.front().instante <= limite)
+        {
+            EventoAresta e = naJanela.front();
+            naJanela.pop_front();
+            registraChegada(e, -1);
+
+            // Só expira se a aresta não chegou de novo depois deste evento
+            unordered_map<unsigned long long, long long>::iterator it = ultimaChegada.find(chave(e.origem, e.destino));
+            if (it != ultimaChegada.end() && it->second == e.instante)
+            {
+                expiradas.push_back(make_pair(e.origem, e.destino));
+                ultimaChegada.erase(it);
+            }
+        }
+        reavaliaCandidatos();
+        return expiradas.empty() ? 0 : g.removeArestasEmLote(expiradas);
+    }
+
+public:
+    int componentes;             // Componentes conexas (fracas, se direcionado) após o último lote
+    long long lotesAplicados;    // Lotes aplicados ao grafo
+    long long eventosRecebidos;  // Eventos recebidos do fluxo
+    long long arestasInseridas;  // Arestas novas no grafo
+    long long arestasExpiradas;  // Arestas removidas pela janela
+    long long agora;             // Instante mais recente aplicado
+    int maisAtivo;               // Vértice com mais chegadas estimadas (-1 se nenhum)
+    long long chegadasMaisAtivo; // Chegadas estimadas do vértice mais ativo
+
+    // Construtor - o grafo pode já ter arestas; elas nunca expiram, a menos que cheguem pelo fluxo.
+    // O esboço erra no máximo 0,1% do total de chegadas com 99% de confiança (2719 x 5
+    // contadores, cerca de 106 KB), qualquer que seja o número de vértices
+    IngestaoFluxo(Grafo &grafo, size_t tamanhoLote, long long janela = 0)
+        : g(grafo), tamanhoLote(max((size_t)1, tamanhoLote)), janela(janela), conexidade(grafo.numVertices),
+          chegadas(EsbocoContagem::comErro(0.001, 0.01)), componentes(grafo.numVertices), lotesAplicados(0), eventosRecebidos(0), arestasInseridas(0),
+          arestasExpiradas(0), agora(0), maisAtivo(-1), chegadasMaisAtivo(0)
+    {
+        pendentes.reserve(this->tamanhoLote);
+        reconstroiConexidade();
+    }
+
+    // Recebe um evento; o lote é aplicado quando fica cheio.
+    // Retorna false (sem enfileirar) se os vértices forem inválidos
+    bool recebe(const EventoAresta &e)
+    {
+        if (e.origem < 0 || e.destino < 0 || e.origem >= g.numVertices || e.destino >= g.numVertices || e.origem == e.destino)
+            return false;
+        pendentes.push_back(e);
+        eventosRecebidos++;
+        if (pendentes.size() >= tamanhoLote)
+            aplicaLote();
+        return true;
+    }
+
+    // Aplica os eventos pendentes ao grafo, atualiza conectividade e estatísticas
+    // e expira as arestas fora da janela
+    void aplicaLote()
+    {
+        if (pendentes.empty())
+            return;
+
+        vector<Aresta> lote;
+        lote.reserve(pendentes.size());
+        for (const EventoAresta &e : pendentes)
+        {
+            lote.push_back({e.origem, e.destino, e.peso});
+        }
+        arestasInseridas += g.adicionaArestasEmLote(lote);
+
+        for (const EventoAresta &e : pendentes)
+        {
+            agora = max(agora, e.instante);
+            conecta(e.origem, e.destino);
+            registraChegada(e, 1);
+            if (janela > 0)
+            {
+                naJanela.push_back(e);
+                long long &ultima = ultimaChegada[chave(e.origem, e.destino)];
+                ultima = max(ultima, e.instante);
+            }
+        }
+        pendentes.clear();
+        lotesAplicados++;
+
+        // O Union-Find não desfaz uniões: se algo expirou, é refeito a partir do grafo
+        if (janela > 0)
+        {
+            int removidas = expira();
+            if (removidas > 0)
+            {
+                arestasExpiradas += removidas;
+                reconstroiConexidade();
+            }
+        }
+    }
+
+    // Eventos recebidos e ainda não aplicados
+    size_t numPendentes() const
+    {
+        return pendentes.size();
+    }
+
+    // Indica se u e v estão na mesma componente (estado do último lote aplicado)
+    bool conectados(int u, int v)
+    {
+        return conexidade.find(u) == conexidade.find(v);
+    }
+
+    // Chegadas estimadas de arestas no vértice v
+    long long chegadasEstimadas(int v) const
+    {
+        return chegadas.estimativa(v);
+    }
+};
+
+// Divisão dos vértices de um grafo em k partes
+struct Particao
+{
+    int numPartes;              // Número de partes
+    vector<int> parte;          // Parte de cada vértice
+    vector<int> tamanho;        // Vértices em cada parte
+    long long arestasCortadas;  // Arestas com extremos em partes diferentes
+};
+
+// Conta os vértices por parte e as arestas cortadas pela divisão
+void calculaCorte(const Grafo &g, Particao &p)
+{
+    p.tamanho.assign(p.numPartes, 0);
+    for (int v = 0; v < g.numVertices; v++)
+    {
+        p.tamanho[p.parte[v]]++;
+    }
+    p.arestasCortadas = 0;
+    for (int u = 0; u < g.numVertices; u++)
+    {
+        g.paraCadaVizinho(u, [&](int v, int)
+                          {
+            if ((g.direcionado || u < v) && p.parte[u] != p.parte[v])
+                p.arestasCortadas++; });
+    }
+}
+
+// Particionamento por hash: equilibrado e sem custo, mas ignora a estrutura do grafo
+Particao particionaHash(const Grafo &g, int k)
+{
+    Particao p;
+    p.numPartes = k;
+    p.parte.resize(g.numVertices);
+    for (int v = 0; v < g.numVertices; v++)
+    {
+        unsigned long long x = (unsigned long long)v * 0x9e3779b97f4a7c15ULL;
+        p.parte[v] = (int)((x >> 32) % (unsigned long long)k);
+    }
+    calculaCorte(g, p);
+    return p;
+}
+
+// Grafo não direcionado com pesos em vértices e arestas (CSR), usado nos níveis
+// do particionamento multinível: cada vértice grosso representa vários vértices finos
+struct GrafoGrosso
+{
+    vector<int> pesoVertice; // Vértices finos representados por cada vértice
+    vector<int> inicio;      // Início dos vizinhos de cada vértice (V + 1)
+    vector<int> vizinho;     // Vizinhos concatenados
+    vector<int> pesoAresta;  // Arestas finas representadas por cada aresta
+
+    int numVertices() const
+    {
+        return (int)pesoVertice.size();
+    }
+};
+
+// Nível mais fino: o grafo original sem sentido, com pesos unitários
+GrafoGrosso grafoGrossoInicial(const Grafo &g)
+{
+    vector<pair<int, int>> arcos;
+    for (int u = 0; u < g.numVertices; u++)
+    {
+        g.paraCadaVizinho(u, [&](int v, int)
+                          {
+            arcos.push_back(make_pair(u, v));
+            if (g.direcionado)
+                arcos.push_back(make_pair(v, u)); });
+    }
+    sort(arcos.begin(), arcos.end());
+
+    GrafoGrosso r;
+    r.pesoVertice.assign(g.numVertices, 1);
+    r.inicio.assign(g.numVertices + 1, 0);
+    for (size_t i = 0; i < arcos.size(); i++)
+    {
+        // Arcos opostos de um grafo direcionado viram uma aresta de peso 2
+        if (i > 0 && arcos[i] == arcos[i - 1])
+        {
+            r.pesoAresta.back()++;
+            continue;
+        }
+        r.vizinho.push_back(arcos[i].second);
+        r.pesoAresta.push_back(1);
+        r.inicio[arcos[i].first + 1]++;
+    }
+    for (int v = 0; v < g.numVertices; v++)
+    {
+        r.inicio[v + 1] += r.inicio[v];
+    }
+    return r;
+}
+
+// Emparelhamento por aresta mais pesada: cada vértice não emparelhado, em ordem
+// aleatória, une-se ao vizinho livre com a aresta de maior peso. mapa recebe o
+// vértice grosso de cada vértice fino; retorna o grafo contraído
+GrafoGrosso contraiGrafo(const GrafoGrosso &g, vector<int> &mapa, mt19937 &rng)
+{
+    int n = g.numVertices();
+    vector<int> ordem(n);
+    for (int v = 0; v < n; v++)
+    {
+        ordem[v] = v;
+    }
+    shuffle(ordem.begin(), ordem.end(), rng);
+
+    mapa.assign(n, -1);
+    int numGrossos = 0;
+    for (int u : ordem)
+    {
+        if (mapa[u] != -1)
+            continue;
+        int melhor = -1, pesoMelhor = 0;
+        for (int i = g.inicio[u]; i < g.inicio[u + 1]; i++)
+        {
+            int v = g.vizinho[i];
+            if (mapa[v] == -1 && g.pesoAresta[i] > pesoMelhor)
+            {
+                melhor = v;
+                pesoMelhor = g.pesoAresta[i];
+            }
+        }
+        mapa[u] = numGrossos;
+        if (melhor != -1)
+            mapa[melhor] = numGrossos;
+        numGrossos++;
+    }
+
+    // Monta as listas do grafo grosso somando arestas paralelas
+    vector<vector<int>> membros(numGrossos);
+    for (int v = 0; v < n; v++)
+    {
+        membros[mapa[v]].push_back(v);
+    }
+    GrafoGrosso r;
+    r.pesoVertice.assign(numGrossos, 0);
+    r.inicio.assign(numGrossos + 1, 0);
+    vector<int> posicao(numGrossos, -1); // Posição do vizinho grosso na linha atual
+    for (int c = 0; c < numGrossos; c++)
+    {
+        size_t comeco = r.vizinho.size();
+        for (int u : membros[c])
+        {
+            r.pesoVertice[c] += g.pesoVertice[u];
+            for (int i = g.inicio[u]; i < g.inicio[u + 1]; i++)
+            {
+                int d = mapa[g.vizinho[i]];
+                if (d == c)
+                    continue; // Aresta interna ao par contraído
+                if (posicao[d] == -1)
+                {
+                    posicao[d] = (int)r.vizinho.size();
+                    r.vizinho.push_back(d);
+                    r.pesoAresta.push_back(0);
+                }
+                r.pesoAresta[posicao[d]] += g.pesoAresta[i];
+            }
+        }
+        for (size_t i = comeco; i < r.vizinho.size(); i++)
+        {
+            posicao[r.vizinho[i]] = -1;
+        }
+        r.inicio[c + 1] = (int)r.vizinho.size();
+    }
+    return r;
+}
+
+// Partição inicial por crescimento guloso: cada parte cresce a partir de uma semente
+// absorvendo o vértice da fronteira mais ligado a ela, até atingir o peso alvo
+vector<int> particaoInicial(const GrafoGrosso &g, int k)
+{
+    int n = g.numVertices();
+    long long pesoTotal = 0;
+    for (int w : g.pesoVertice)
+        pesoTotal += w;
+
+    vector<int> parte(n, -1);
+    vector<long long> ligacao(n, 0); // Peso das arestas para a parte em crescimento
+    int proximaSemente = 0;
+    long long pesoAtribuido = 0;
+    for (int p = 0; p < k - 1; p++)
+    {
+        long long alvo = (pesoTotal - pesoAtribuido) / (k - p);
+        long long peso = 0;
+        priority_queue<pair<long long, int>> fronteira;
+        vector<int> tocados;
+        while (peso < alvo)
+        {
+            if (fronteira.empty())
+            {
+                // Semente nova (início ou componente esgotada)
+                while (proximaSemente < n && parte[proximaSemente] != -1)
+                    proximaSemente++;
+                if (proximaSemente == n)
+                    break;
+                fronteira.push(make_pair(0LL, proximaSemente));
+            }
+            int u = fronteira.top().second;
+            long long l = fronteira.top().first;
+            fronteira.pop();
+            if (parte[u] != -1 || l != ligacao[u])
+                continue; // Entrada desatualizada
+            parte[u] = p;
+            peso += g.pesoVertice[u];
+            for (int i = g.inicio[u]; i < g.inicio[u + 1]; i++)
+            {
+                int v = g.vizinho[i];
+                if (parte[v] == -1)
+                {
+                    if (ligacao[v] == 0)
+                        tocados.push_back(v);
+                    ligacao[v] += g.pesoAresta[i];
+                    fronteira.push(make_pair(ligacao[v], v));
+                }
+            }
+        }
+        for (int v : tocados)
+            ligacao[v] = 0;
+        pesoAtribuido += peso;
+    }
+    for (int v = 0; v < n; v++)
+    {
+        if (parte[v] == -1)
+            parte[v] = k - 1; // A última parte fica com o restante
+    }
+    return parte;
+}
+
+// Refinamento de fronteira: move vértices para a parte vizinha com maior ganho de
+// corte, respeitando o desequilíbrio máximo, até não haver movimento que ajude
+void refinaParticao(const GrafoGrosso &g, int k, vector<int> &parte, double desequilibrio)
+{
+    int n = g.numVertices();
+    long long pesoTotal = 0;
+    vector<long long> pesoParte(k, 0);
+    for (int v = 0; v < n; v++)
+    {
+        pesoTotal += g.pesoVertice[v];
+        pesoParte[parte[v]] += g.pesoVertice[v];
+    }
+    long long pesoMaximo = (long long)(desequilibrio * pesoTotal / k) + 1;
+
+    vector<long long> ligacao(k, 0);
+    vector<int> partesVizinhas;
+    for (int passada = 0; passada < 8; passada++)
+    {
+        int movidos = 0;
+        for (int u = 0; u < n; u++)
+        {
+            // Peso das arestas de u para cada parte vizinha
+            partesVizinhas.clear();
+            for (int i = g.inicio[u]; i < g.inicio[u + 1]; i++)
+            {
+                int p = parte[g.vizinho[i]];
+                if (ligacao[p] == 0)
+                    partesVizinhas.push_back(p);
+                ligacao[p] += g.pesoAresta[i];
+            }
+
+            int atual = parte[u], melhor = atual;
+            long long ganhoMelhor = 0;
+            for (int p : partesVizinhas)
+            {
+                if (p == atual || pesoParte[p] + g.pesoVertice[u] > pesoMaximo)
+                    continue;
+                long long ganho = ligacao[p] - ligacao[atual];
+                // Empate no corte só move se melhorar o equilíbrio
+                if (ganho > ganhoMelhor || (ganho == 0 && ganhoMelhor == 0 && melhor == atual &&
+                                            pesoParte[p] + g.pesoVertice[u] < pesoParte[atual]))
+                {
+                    melhor = p;
+                    ganhoMelhor = ganho;
+                }
+            }
+            for (int p : partesVizinhas)
+                ligacao[p] = 0;
+
+            if (melhor != atual)
+            {
+                pesoParte[atual] -= g.pesoVertice[u];
+                pesoParte[melhor] += g.pesoVertice[u];
+                parte[u] = melhor;
+                movidos++;
+            }
+        }
+        if (movidos == 0)
+            break;
+    }
+}
+
+// Particionamento multinível (no estilo do METIS): contrai o grafo por emparelhamento
+// de arestas pesadas, divide o grafo mais grosso por crescimento guloso e projeta a
+// divisão de volta refinando a fronteira em cada nível
+Particao particionaMultinivel(const Grafo &g, int k, double desequilibrio = 1.05)
+{
+    mt19937 rng(12345); // Semente fixa: a mesma entrada gera a mesma partição
+    vector<GrafoGrosso> niveis;
+    vector<vector<int>> mapas;
+    niveis.push_back(grafoGrossoInicial(g));
+
+    int limite = max(20 * k, 100);
+    while (niveis.back().numVertices() > limite)
+    {
+        vector<int> mapa;
+        GrafoGrosso grosso = contraiGrafo(niveis.back(), mapa, rng);
+        // Contração que quase não reduz (grafo sem arestas, estrela) encerra a fase
+        if (grosso.numVertices() > niveis.back().numVertices() * 95 / 100)
+            break;
+        mapas.push_back(mapa);
+        niveis.push_back(grosso);
+    }
+
+    vector<int> parte = particaoInicial(niveis.back(), k);
+    refinaParticao(niveis.back(), k, parte, desequilibrio);
+    for (int nivel = (int)mapas.size() - 1; nivel >= 0; nivel--)
+    {
+        vector<int> fina(niveis[nivel].numVertices());
+        for (size_t v = 0; v < fina.size(); v++)
+        {
+            fina[v] = parte[mapas[nivel][v]];
+        }
+        parte.swap(fina);
+        refinaParticao(niveis[nivel], k, parte, desequilibrio);
+    }
+
+    Particao p;
+    p.numPartes = k;
+    p.parte = parte;
+    calculaCorte(g, p);
+    return p;
+}
+
+// Memória visível por todos os trabalhadores do motor BSP: mapeamento anônimo
+// compartilhado (sobrevive ao fork) em POSIX, memória comum nas demais plataformas
+void *alocaCompartilhado(size_t bytes)
+{
+#ifdef GRAFO_PROCESSOS
+    void *p = mmap(nullptr, max(bytes, (size_t)1), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    return p == MAP_FAILED ? nullptr : p;
+#else
+    return ::operator new(max(bytes, (size_t)1), nothrow);
+#endif
+}
+
+void liberaCompartilhado(void *p, size_t bytes)
+{
+    if (p == nullptr)
+        return;
+#ifdef GRAFO_PROCESSOS
+    munmap(p, max(bytes, (size_t)1));
+#else
+    (void)bytes;
+    ::operator delete(p);
+#endif
+}
+
+// Barreira com inversão de sentido para trabalhadores em memória compartilhada.
+// Usa só atômicos sem trava, então vale entre processos; abortado libera quem espera
+struct BarreiraCompartilhada
+{
+    atomic<int> restantes; // Trabalhadores que ainda não chegaram
+    atomic<int> sentido;   // Alterna a cada rodada completa
+    atomic<int> abortado;  // Algum trabalhador terminou de forma anormal
+    int total;             // Número de trabalhadores
+
+    void inicia(int n)
+    {
+        total = n;
+        restantes.store(n);
+        sentido.store(0);
+        abortado.store(0);
+    }
+
+    // Espera todos chegarem; sentidoLocal é o estado privado de cada trabalhador.
+    // Retorna false se a execução foi abortada
+    bool espera(int &sentidoLocal)
+    {
+        sentidoLocal = 1 - sentidoLocal;
+        if (restantes.fetch_sub(1) == 1)
+        {
+            // O último a chegar rearma a barreira e libera os demais
+            restantes.store(total);
+            sentido.store(sentidoLocal);
+            return abortado.load() == 0;
+        }
+        while (sentido.load() != sentidoLocal)
+        {
+            if (abortado.load() != 0)
+                return false;
+            this_thread::yield();
+        }
+        return abortado.load() == 0;
+    }
+};
+
+// Vértices de uma parte com seus arcos de saída em CSR. Ids locais: primeiro os
+// vértices da parte, depois os fantasmas (destinos em outras partes)
+struct ParteLocal
+{
+    int numDonos;              // Vértices pertencentes à parte
+    vector<int> global;        // Id global de cada vértice local (donos e fantasmas)
+    vector<int> inicio;        // Início dos arcos de cada dono (numDonos + 1)
+    vector<int> destino;       // Destino local de cada arco
+    vector<int> peso;          // Peso de cada arco
+    vector<int> donoFantasma;  // Parte dona de cada fantasma
+    vector<int> idNoDono;      // Id local do fantasma na parte dona
+
+    int numFantasmas() const
+    {
+        return (int)global.size() - numDonos;
+    }
+};
+
+// Motor BSP (superpassos síncronos) com k trabalhadores, um por parte. Em cada
+// superpasso cada trabalhador processa sua parte, envia às partes donas as distâncias
+// novas dos fantasmas (uma mensagem por fantasma, a menor) e espera na barreira;
+// depois lê as mensagens recebidas. Em POSIX os trabalhadores são processos (fork) e
+// as caixas de mensagens ficam em memória compartilhada; senão, threads
+class MotorBSP
+{
+public:
+    enum Algoritmo
+    {
+        BSP_BFS,
+        BSP_BELLMAN_FORD
+    };
+
+    enum { INF = 999999 };
+
+    // Mensagem de distância para um vértice da parte destino
+    struct Mensagem
+    {
+        int vertice;   // Id local no destino
+        int distancia; // Distância candidata
+    };
+
+    int superpassos;      // Superpassos da última execução
+    long long mensagens;  // Mensagens trocadas na última execução
+
+private:
+    // Estado compartilhado de uma execução
+    struct Controle
+    {
+        BarreiraCompartilhada barreira;
+        atomic<long long> ativos[3];  // Trabalho pendente por superpasso (rodízio de 3)
+        atomic<int> ciclo[3];         // Ciclo negativo visto no superpasso (mesmo rodízio)
+        atomic<long long> mensagens;  // Mensagens enviadas no total
+        atomic<int> superpassos;      // Superpassos executados
+        atomic<int> cicloNegativo;    // Bellman-Ford encontrou ciclo negativo (resultado final)
+    };
+
+    int numPartes;
+    int numVertices;
+    vector<ParteLocal> partes;
+    vector<long long> inicioCaixa; // Início da caixa (origem, destino) no buffer de mensagens
+    long long totalCaixas;         // Mensagens de um superpasso, somando todas as caixas
+
+    // Ponteiros válidos durante executa()
+    Controle *controle;
+    Mensagem *caixas;     // Dois buffers (paridade do superpasso)
+    int *contagem;        // Mensagens em cada caixa, por paridade: [2][k][k]
+    int *resultado;       // Distâncias globais escritas por cada dono
+
+    // Trabalho de uma parte do início ao fim
+    void trabalha(int id, Algoritmo algoritmo, int origem)
+    {
+        const ParteLocal &p = partes[id];
+        int numLocais = (int)p.global.size();
+        vector<int> dist(numLocais, INF);
+        vector<int> fronteira, proximo, tocados;
+        vector<char> marcado(numLocais, 0);     // Em proximo (donos) ou em tocados (fantasmas)
+        vector<int> vezesNaFila(p.numDonos, 0); // Saídas da fila no superpasso (ciclo negativo local)
+        int sentidoLocal = 0;
+
+        for (int u = 0; u < p.numDonos; u++)
+        {
+            if (p.global[u] == origem)
+            {
+                dist[u] = 0;
+                fronteira.push_back(u);
+            }
+        }
+
+        for (int s = 0;; s++)
+        {
+            int paridade = s & 1;
+            proximo.clear();
+            tocados.clear();
+
+            // Computação local
+            if (algoritmo == BSP_BFS)
+            {
+                for (int u : fronteira)
+                {
+                    for (int i = p.inicio[u]; i < p.inicio[u + 1]; i++)
+                    {
+                        int v = p.destino[i];
+                        if (dist[v] != INF)
+                            continue;
+                        dist[v] = dist[u] + 1;
+                        if (v < p.numDonos)
+                            proximo.push_back(v);
+                        else
+                            tocados.push_back(v);
+                    }
+                }
+            }
+            else
+            {
+                // Bellman-Ford com fila (SPFA) até o ponto fixo dentro da parte; sem ciclo
+                // negativo, nenhum vértice sai da fila mais vezes que os vértices da parte
+                deque<int> fila(fronteira.begin(), fronteira.end());
+                for (int u : fronteira)
+                    marcado[u] = 1;
+                fill(vezesNaFila.begin(), vezesNaFila.end(), 0);
+                while (!fila.empty())
+                {
+                    int u = fila.front();
+                    fila.pop_front();
+                    marcado[u] = 0;
+                    if (++vezesNaFila[u] > p.numDonos)
+                    {
+                        controle->ciclo[s % 3].store(1);
+                        break;
+                    }
+                    for (int i = p.inicio[u]; i < p.inicio[u + 1]; i++)
+                    {
+                        int v = p.destino[i];
+                        int nd = dist[u] + p.peso[i];
+                        if (nd >= dist[v])
+                            continue;
+                        dist[v] = nd;
+                        if (marcado[v])
+                            continue;
+                        marcado[v] = 1;
+                        if (v < p.numDonos)
+                            fila.push_back(v);
+                        else
+                            tocados.push_back(v);
+                    }
+                }
+                for (int u : fila)
+                    marcado[u] = 0;
+            }
+
+            // Envio: uma mensagem por fantasma alterado
+            int *contagemEnvio = contagem + (size_t)paridade * numPartes * numPartes + (size_t)id * numPartes;
+            for (int j = 0; j < numPartes; j++)
+                contagemEnvio[j] = 0;
+            for (int v : tocados)
+            {
+                int f = v - p.numDonos;
+                int j = p.donoFantasma[f];
+                Mensagem *caixa = caixas + paridade * totalCaixas + inicioCaixa[(size_t)id * numPartes + j];
+                caixa[contagemEnvio[j]++] = {p.idNoDono[f], dist[v]};
+                marcado[v] = 0;
+            }
+            controle->mensagens.fetch_add((long long)tocados.size());
+            controle->ativos[s % 3].fetch_add((long long)(tocados.size() + proximo.size()));
+
+            if (!controle->barreira.espera(sentidoLocal))
+                return;
+            if (id == 0)
+            {
+                // Próximo uso só após a barreira seguinte
+                controle->ativos[(s + 2) % 3].store(0);
+                controle->ciclo[(s + 2) % 3].store(0);
+                controle->superpassos.store(s + 1);
+            }
+
+            // Sem ciclo negativo, um caminho mínimo cruza partes menos de V vezes;
+            // todos avaliam a mesma condição e param no mesmo superpasso
+            if (controle->ciclo[s % 3].load() != 0 || (algoritmo == BSP_BELLMAN_FORD && s > numVertices))
+            {
+                controle->cicloNegativo.store(1);
+                break;
+            }
+            if (controle->ativos[s % 3].load() == 0)
+                break;
+
+            // Recebimento
+            for (int j = 0; j < numPartes; j++)
+            {
+                int n = contagem[(size_t)paridade * numPartes * numPartes + (size_t)j * numPartes + id];
+                const Mensagem *caixa = caixas + paridade * totalCaixas + inicioCaixa[(size_t)j * numPartes + id];
+                for (int m = 0; m < n; m++)
+                {
+                    int v = caixa[m].vertice;
+                    if (caixa[m].distancia < dist[v])
+                    {
+                        dist[v] = caixa[m].distancia;
+                        if (!marcado[v])
+                        {
+                            marcado[v] = 1;
+                            proximo.push_back(v);
+                        }
+                    }
+                }
+            }
+            for (int v : proximo)
+                marcado[v] = 0;
+            fronteira.swap(proximo);
+        }
+
+        for (int u = 0; u < p.numDonos; u++)
+        {
+            resultado[p.global[u]] = dist[u];
+        }
+    }
+
+public:
+    // Construtor - monta cada parte com seus fantasmas e dimensiona as caixas de mensagens
+    MotorBSP(const Grafo &g, const Particao &particao)
+        : superpassos(0), mensagens(0), numPartes(particao.numPartes), numVertices(g.numVertices),
+          controle(nullptr), caixas(nullptr), contagem(nullptr), resultado(nullptr)
+    {
+        partes.resize(numPartes);
+        vector<int> idLocal(numVertices); // Id de cada vértice na sua parte dona
+        for (int v = 0; v < numVertices; v++)
+        {
+            ParteLocal &p = partes[particao.parte[v]];
+            idLocal[v] = (int)p.global.size();
+            p.global.push_back(v);
+        }
+
+        vector<int> localDe(numVertices, -1); // Id local na parte em montagem (donos e fantasmas)
+        vector<long long> capacidade((size_t)numPartes * numPartes, 0);
+        for (int id = 0; id < numPartes; id++)
+        {
+            ParteLocal &p = partes[id];
+            p.numDonos = (int)p.global.size();
+            for (int u = 0; u < p.numDonos; u++)
+                localDe[p.global[u]] = u;
+
+            p.inicio.assign(p.numDonos + 1, 0);
+            for (int u = 0; u < p.numDonos; u++)
+            {
+                g.paraCadaVizinho(p.global[u], [&](int v, int peso)
+                                  {
+                    if (localDe[v] == -1)
+                    {
+                        // Primeiro arco para v: vira fantasma desta parte
+                        localDe[v] = (int)p.global.size();
+                        p.global.push_back(v);
+                        p.donoFantasma.push_back(particao.parte[v]);
+                        p.idNoDono.push_back(idLocal[v]);
+                        capacidade[(size_t)id * numPartes + particao.parte[v]]++;
+                    }
+                    p.destino.push_back(localDe[v]);
+                    p.peso.push_back(peso); });
+                p.inicio[u + 1] = (int)p.destino.size();
+            }
+            for (int v : p.global)
+                localDe[v] = -1;
+        }
+
+        // Cada fantasma recebe no máximo uma mensagem por superpasso
+        inicioCaixa.assign((size_t)numPartes * numPartes, 0);
+        totalCaixas = 0;
+        for (size_t c = 0; c < capacidade.size(); c++)
+        {
+            inicioCaixa[c] = totalCaixas;
+            totalCaixas += capacidade[c];
+        }
+    }
+
+    // Vértices fantasmas somados em todas as partes
+    long long totalFantasmas() const
+    {
+        long long total = 0;
+        for (const ParteLocal &p : partes)
+            total += p.numFantasmas();
+        return total;
+    }
+
+    // Executa BFS ou Bellman-Ford a partir de origem; dist recebe as distâncias
+    // (INF se inalcançável). Retorna false se houver ciclo negativo ou falha
+    bool executa(Algoritmo algoritmo, int origem, vector<int> &dist, bool usaProcessos = true)
+    {
+        size_t bytesControle = sizeof(Controle);
+        size_t bytesCaixas = 2 * (size_t)totalCaixas * sizeof(Mensagem);
+        size_t bytesContagem = 2 * (size_t)numPartes * numPartes * sizeof(int);
+        size_t bytesResultado = (size_t)numVertices * sizeof(int);
+        controle = (Controle *)alocaCompartilhado(bytesControle);
+        caixas = (Mensagem *)alocaCompartilhado(bytesCaixas);
+        contagem = (int *)alocaCompartilhado(bytesContagem);
+        resultado = (int *)alocaCompartilhado(bytesResultado);
+
+        bool sucesso = controle && caixas && contagem && resultado;
+        if (!sucesso)
+        {
+            cerr << "Nao foi possivel alocar a memoria compartilhada" << endl;
+        }
+        else
+        {
+            new (controle) Controle();
+            controle->barreira.inicia(numPartes);
+            for (int i = 0; i < 3; i++)
+            {
+                controle->ativos[i].store(0);
+                controle->ciclo[i].store(0);
+            }
+            controle->mensagens.store(0);
+            controle->superpassos.store(0);
+            controle->cicloNegativo.store(0);
+            for (int v = 0; v < numVertices; v++)
+                resultado[v] = INF;
+
+#ifdef GRAFO_PROCESSOS
+            if (usaProcessos)
+                sucesso = executaProcessos(algoritmo, origem);
+            else
+#endif
+                executaThreads(algoritmo, origem);
+            (void)usaProcessos;
+
+            sucesso = sucesso && controle->barreira.abortado.load() == 0 && controle->cicloNegativo.load() == 0;
+            superpassos = controle->superpassos.load();
+            mensagens = controle->mensagens.load();
+            dist.assign(resultado, resultado + numVertices);
+            controle->~Controle();
+        }
+
+        liberaCompartilhado(controle, bytesControle);
+        liberaCompartilhado(caixas, bytesCaixas);
+        liberaCompartilhado(contagem, bytesContagem);
+        liberaCompartilhado(resultado, bytesResultado);
+        controle = nullptr;
+        caixas = nullptr;
+        contagem = nullptr;
+        resultado = nullptr;
+        return sucesso;
+    }
+
+private:
+    // Um thread por parte no mesmo processo
+    void executaThreads(Algoritmo algoritmo, int origem)
+    {
+        vector<thread> trabalhadores;
+        for (int id = 0; id < numPartes; id++)
+        {
+            trabalhadores.emplace_back([this, id, algoritmo, origem]()
+                                       { trabalha(id, algoritmo, origem); });
+        }
+        for (thread &t : trabalhadores)
+            t.join();
+    }
+
+#ifdef GRAFO_PROCESSOS
+    // Um processo filho por parte; o pai só acompanha os filhos e aborta a
+    // execução se algum terminar de forma anormal
+    bool executaProcessos(Algoritmo algoritmo, int origem)
+    {
+        cout.flush(); // Evita que os filhos herdem e repitam saída pendente
+        cerr.flush();
+        vector<pid_t> filhos;
+        for (int id = 0; id < numPartes; id++)
+        {
+            pid_t pid = fork();
+            if (pid == 0)
+            {
+                trabalha(id, algoritmo, origem);
+                _exit(0);
+            }
+            if (pid < 0)
+            {
+                cerr << "Falha ao criar processo trabalhador" << endl;
+                controle->barreira.abortado.store(1);
+                break;
+            }
+            filhos.push_back(pid);
+        }
+
+        // Recolhe só os trabalhadores criados aqui, sem tocar em outros filhos do processo.
+        // A consulta não bloqueia para que a falha de qualquer um aborte os demais,
+        // que de outro modo ficariam presos na barreira
+        bool sucesso = (int)filhos.size() == numPartes;
+        while (!filhos.empty())
+        {
+            bool recolheu = false;
+            for (size_t i = 0; i < filhos.size();)
+            {
+                int estado;
+                pid_t pid = waitpid(filhos[i], &estado, WNOHANG);
+                if (pid == 0)
+                {
+                    i++; // Ainda executando
+                    continue;
+                }
+                if (pid < 0 || !WIFEXITED(estado) || WEXITSTATUS(estado) != 0)
+                {
+                    sucesso = false;
+                    controle->barreira.abortado.store(1);
+                }
+                filhos[i] = filhos.back();
+                filhos.pop_back();
+                recolheu = true;
+            }
+            if (!recolheu && !filhos.empty())
+                this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        return sucesso;
+    }
+#endif
+};
+
+// Conjunto fixo de threads que executam tarefas de uma fila compartilhada
+class PoolTrabalhadores
+{
+private:
+    vector<thread> threads;          // Threads trabalhadoras
+    queue<function<void()>> tarefas; // Tarefas aguardando execução
+    mutex trava;                     // Protege a fila e os contadores
+    condition_variable temTarefa;    // Sinaliza nova tarefa ou encerramento
+    condition_variable terminou;     // Sinaliza que todas as tarefas acabaram
+    int pendentes;                   // Tarefas enfileiradas ou em execução
+    bool encerrando;                 // Indica que o pool está sendo destruído
+
+    // Laço de cada thread: retira e executa tarefas até o encerramento
+    void laco()
+    {
+        while (true)
+        {
+            function<void()> tarefa;
+            {
+                unique_lock<mutex> guarda(trava);
+                temTarefa.wait(guarda, [this]()
+                               { return encerrando || !tarefas.empty(); });
+                if (tarefas.empty())
+                    return; // Encerrando e sem trabalho restante
+                tarefa = tarefas.front();
+                tarefas.pop();
+            }
+
+            tarefa();
+
+            unique_lock<mutex> guarda(trava);
+            if (--pendentes == 0)
+                terminou.notify_all();
+        }
+    }
+
+public:
+    // Construtor - cria numThreads threads (pelo menos uma)
+    PoolTrabalhadores(int numThreads) : pendentes(0), encerrando(false)
+    {
+        if (numThreads < 1)
+            numThreads = 1;
+        for (int i = 0; i < numThreads; i++)
+        {
+            threads.push_back(thread(&PoolTrabalhadores::laco, this));
+        }
+    }
+
+    // Destrutor - termina as tarefas pendentes e encerra as threads
+    ~PoolTrabalhadores()
+    {
+        {
+            unique_lock<mutex> guarda(trava);
+            encerrando = true;
+        }
+        temTarefa.notify_all();
+        for (auto &t : threads)
+        {
+            t.join();
+        }
+    }
+
+    // Enfileira uma tarefa
+    void executa(function<void()> tarefa)
+    {
+        {
+            unique_lock<mutex> guarda(trava);
+            tarefas.push(tarefa);
+            pendentes++;
+        }
+        temTarefa.notify_one();
+    }
+
+    // Bloqueia até todas as tarefas enfileiradas terminarem
+    void aguarda()
+    {
+        unique_lock<mutex> guarda(trava);
+        terminou.wait(guarda, [this]()
+                      { return pendentes == 0; });
+    }
+
+    // Número de threads do pool
+    int tamanho() const
+    {
+        return (int)threads.size();
+    }
+};
+
+// Grafo com os arcos invertidos em CSR, montado a partir de qualquer fonte de vizinhos;
+// serve para calcular distâncias até um vértice com os mesmos algoritmos
+struct GrafoTransposto
+{
+    int numVertices;     // Número de vértices
+    vector<int> inicio;  // Início dos arcos que chegam em cada vértice (V + 1)
+    vector<int> vizinho; // Origem de cada arco
+    vector<int> peso;    // Peso de cada arco
+
+    template <typename Fonte>
+    explicit GrafoTransposto(const Fonte &g) : numVertices(g.numVertices), inicio(g.numVertices + 1, 0)
+    {
+        for (int u = 0; u < numVertices; u++)
+        {
+            g.paraCadaVizinho(u, [&](int v, int)
+                              { inicio[v + 1]++; });
+        }
+        for (int v = 0; v < numVertices; v++)
+        {
+            inicio[v + 1] += inicio[v];
+        }
+        vizinho.resize(inicio[numVertices]);
+        peso.resize(inicio[numVertices]);
+        vector<int> proxima(inicio.begin(), inicio.end() - 1);
+        for (int u = 0; u < numVertices; u++)
+        {
+            g.paraCadaVizinho(u, [&](int v, int w)
+                              {
+                vizinho[proxima[v]] = u;
+                peso[proxima[v]++] = w; });
+        }
+    }
+
+    template <typename Funcao>
+    void paraCadaVizinho(int u, Funcao f) const
+    {
+        for (int i = inicio[u]; i < inicio[u + 1]; i++)
+        {
+            f(vizinho[i], peso[i]);
+        }
+    }
+};
+
+// Critério de escolha dos marcos do oráculo de distâncias
+enum SelecaoMarcos
+{
+    MARCOS_ALEATORIOS, // Sorteio uniforme
+    MARCOS_GRAU,       // Vértices de maior grau
+    MARCOS_DISTANTES   // Cada marco é o vértice mais distante dos já escolhidos
+};
+
+// Oráculo de distâncias aproximadas por marcos: guarda as distâncias entre cada
+// vértice e k marcos (tabela V × k, e a transposta em grafo direcionado) e estima
+// d(s, t) em O(k) pela desigualdade triangular, sem o O(V²) de Floyd
+class OraculoDistancias
+{
+public:
+    enum { INF = 999999 };
+
+    // Limites da distância: inferior <= d(s, t) <= superior (INF = desconhecido/inalcançável)
+    struct Estimativa
+    {
+        int inferior;
+        int superior;
+    };
+
+private:
+    int k;                 // Número de marcos
+    bool direcionado;      // Se a tabela paraMarco é necessária
+    vector<int> marcos;    // Vértices escolhidos como marcos
+    vector<int> deMarco;   // deMarco[v * k + i] = d(marco i, v)
+    vector<int> paraMarco; // paraMarco[v * k + i] = d(v, marco i) (só direcionado)
+
+    // Preenche a coluna i da tabela com as distâncias a partir de origem em g
+    template <typename Fonte>
+    void preencheColuna(const Fonte &g, int origem, int i, vector<int> &tabela)
+    {
+        EspacoTrabalho &ws = EspacoTrabalho::daThread();
+        caminhosMinimos(g, origem, ws);
+        for (int v = 0; v < numVertices; v++)
+        {
+            tabela[(size_t)v * k + i] = ws.distancia(v);
+        }
+    }
+
+public:
+    int numVertices; // Número de vértices do grafo
+
+    // Construtor - escolhe os marcos e calcula as tabelas com um Dijkstra por marco
+    // (e outro no grafo transposto, se direcionado) distribuídos no pool
+    template <typename Fonte>
+    OraculoDistancias(const Fonte &g, int numMarcos, SelecaoMarcos criterio, PoolTrabalhadores &pool, unsigned semente = 1)
+        : k(max(1, min(numMarcos, g.numVertices))), direcionado(g.direcionado), numVertices(g.numVertices)
+    {
+        deMarco.assign((size_t)numVertices * k, INF);
+        mt19937 rng(semente);
+
+        if (criterio == MARCOS_DISTANTES)
+        {
+            // Sequencial: cada escolha depende das distâncias dos marcos anteriores.
+            // Vértices inalcançáveis contam como infinitamente distantes (cobre outras componentes)
+            vector<int> maisProximo(numVertices, INF);
+            int proximo = (int)(rng() % numVertices);
+            for (int i = 0; i < k; i++)
+            {
+                marcos.push_back(proximo);
+                preencheColuna(g, proximo, i, deMarco);
+                maisProximo[proximo] = -1; // Já escolhido
+                int melhor = -1;
+                for (int v = 0; v < numVertices; v++)
+                {
+                    if (maisProximo[v] >= 0)
+                        maisProximo[v] = min(maisProximo[v], deMarco[(size_t)v * k + i]);
+                    if (maisProximo[v] >= 0 && (melhor == -1 || maisProximo[v] > maisProximo[melhor]))
+                        melhor = v;
+                }
+                proximo = melhor;
+            }
+        }
+        else
+        {
+            vector<int> candidatos(numVertices);
+            for (int v = 0; v < numVertices; v++)
+                candidatos[v] = v;
+            if (criterio == MARCOS_GRAU)
+            {
+                vector<int> grau(numVertices, 0);
+                for (int u = 0; u < numVertices; u++)
+                    g.paraCadaVizinho(u, [&](int, int)
+                                      { grau[u]++; });
+                partial_sort(candidatos.begin(), candidatos.begin() + k, candidatos.end(), [&](int a, int b)
+                             { return grau[a] != grau[b] ? grau[a] > grau[b] : a < b; });
+            }
+            else
+            {
+                // Fisher-Yates parcial: só as k primeiras posições
+                for (int i = 0; i < k; i++)
+                    swap(candidatos[i], candidatos[i + rng() % (numVertices - i)]);
+            }
+            marcos.assign(candidatos.begin(), candidatos.begin() + k);
+
+            for (int i = 0; i < k; i++)
+            {
+                pool.executa([this, &g, i]()
+                             { preencheColuna(g, marcos[i], i, deMarco); });
+            }
+        }
+
+        if (direcionado)
+        {
+            paraMarco.assign((size_t)numVertices * k, INF);
+            GrafoTransposto transposto(g);
+            for (int i = 0; i < k; i++)
+            {
+                pool.executa([this, &transposto, i]()
+                             { preencheColuna(transposto, marcos[i], i, paraMarco); });
+            }
+            pool.aguarda(); // transposto é local: as tarefas precisam terminar aqui
+        }
+        else
+        {
+            pool.aguarda();
+        }
+    }
+
+    // Estima d(s, t) em O(k). Superior: menor caminho s -> marco -> t.
+    // Inferior: maior diferença d(marco, t) - d(marco, s) ou d(s, marco) - d(t, marco);
+    // alcance diferente a partir de um marco prova que t é inalcançável a partir de s
+    Estimativa estima(int s, int t) const
+    {
+        if (s == t)
+            return {0, 0};
+
+        const int *ds = &deMarco[(size_t)s * k], *dt = &deMarco[(size_t)t * k];
+        const int *ps = direcionado ? &paraMarco[(size_t)s * k] : ds;
+        const int *pt = direcionado ? &paraMarco[(size_t)t * k] : dt;
+        int inferior = 0, superior = INF;
+        for (int i = 0; i < k; i++)
+        {
+            if (ps[i] != INF && dt[i] != INF)
+                superior = min(superior, ps[i] + dt[i]);
+
+            if (direcionado)
+            {
+                if (ds[i] != INF)
+                    inferior = dt[i] == INF ? INF : max(inferior, dt[i] - ds[i]);
+                if (pt[i] != INF && inferior != INF)
+                    inferior = ps[i] == INF ? INF : max(inferior, ps[i] - pt[i]);
+            }
+            else if ((ds[i] == INF) != (dt[i] == INF))
+            {
+                inferior = INF; // Componentes diferentes
+            }
+            else if (ds[i] != INF)
+            {
+                inferior = max(inferior, abs(ds[i] - dt[i]));
+            }
+            if (inferior == INF)
+                return {INF, INF};
+        }
+        return {inferior, superior};
+    }
+
+    // Vértices usados como marcos
+    const vector<int> &listaMarcos() const
+    {
+        return marcos;
+    }
+
+    // Memória das tabelas, em bytes
+    size_t memoriaBytes() const
+    {
+        return (deMarco.capacity() + paraMarco.capacity()) * sizeof(int);
+    }
+};
+
+// Potenciais de Johnson: Bellman-Ford com fila (SPFA) a partir de um vértice virtual
+// ligado a todos com peso 0. Com eles, w(u, v) + h[u] - h[v] >= 0 em todo arco.
+// Retorna false se houver ciclo negativo
+template <typename Fonte>
+bool potenciaisJohnson(const Fonte &grafo, vector<int> &h)
+{
+    int n = grafo.numVertices;
+    h.assign(n, 0); // Distância a partir do vértice virtual
+    vector<int> vezesNaFila(n, 0);
+    vector<char> naFila(n, 1);
+    deque<int> fila;
+    for (int v = 0; v < n; v++)
+        fila.push_back(v);
+
+    while (!fila.empty())
+    {
+        int u = fila.front();
+        fila.pop_front();
+        naFila[u] = 0;
+
+        // Em ordem FIFO, sem ciclo negativo, cada vértice sai da fila no máximo uma vez
+        // por rodada, e há no máximo V rodadas
+        if (++vezesNaFila[u] > n)
+            return false;
+
+        int hu = h[u];
+        grafo.paraCadaVizinho(u, [&](int v, int peso)
+                              {
+            if (hu + peso < h[v])
+            {
+                h[v] = hu + peso;
+                if (!naFila[v])
+                {
+                    naFila[v] = 1;
+                    fila.push_back(v);
+                }
+            } });
+    }
+    return true;
+}
+
+// Visão de um grafo com os pesos repesados pelos potenciais de Johnson; não copia
+// arestas e permite usar caminhosMinimos com pesos originalmente negativos
+template <typename Fonte>
+struct GrafoRepesado
+{
+    const Fonte &grafo;   // Grafo original
+    const vector<int> &h; // Potenciais de potenciaisJohnson
+    int numVertices;      // Número de vértices
+
+    GrafoRepesado(const Fonte &g, const vector<int> &potenciais)
+        : grafo(g), h(potenciais), numVertices(g.numVertices) {}
+
+    template <typename Funcao>
+    void paraCadaVizinho(int u, Funcao f) const
+    {
+        int hu = h[u];
+        grafo.paraCadaVizinho(u, [&](int v, int peso)
+                              { f(v, peso + hu - h[v]); });
+    }
+};
+
+// Johnson: caminhos mínimos entre todos os pares em O(V E log V), aceitando pesos
+// negativos. Os V Dijkstras são divididos em blocos de origens entre as threads do pool;
+// entregaLinha(s, linha) recebe as V distâncias a partir de s (INF se inalcançável),
+// chamada por várias threads ao mesmo tempo com linhas diferentes.
+// Retorna false (sem entregar linhas) se houver ciclo negativo
+template <typename Fonte, typename Funcao>
+bool todosParesJohnson(const Fonte &grafo, PoolTrabalhadores &pool, Funcao entregaLinha)
+{
+    vector<int> h;
+    if (!potenciaisJohnson(grafo, h))
+        return false;
+
+    GrafoRepesado<Fonte> repesado(grafo, h);
+    int n = grafo.numVertices;
+    int numBlocos = pool.tamanho() * 4; // Blocos extras equilibram origens de custo desigual
+    int tamanhoBloco = max(1, (n + numBlocos - 1) / numBlocos);
+
+    for (int inicio = 0; inicio < n; inicio += tamanhoBloco)
+    {
+        int fim = min(n, inicio + tamanhoBloco);
+        pool.executa([&repesado, &h, &entregaLinha, n, inicio, fim]()
+                     {
+            EspacoTrabalho &ws = EspacoTrabalho::daThread();
+            vector<int> linha(n);
+            for (int s = inicio; s < fim; s++)
+            {
+                caminhosMinimos(repesado, s, ws);
+                for (int t = 0; t < n; t++)
+                {
+                    // Desfaz a repesagem: d(s, t) = d'(s, t) - h[s] + h[t]
+                    int d = ws.distancia(t);
+                    linha[t] = d == EspacoTrabalho::INF ? EspacoTrabalho::INF : d - h[s] + h[t];
+                }
+                entregaLinha(s, linha.data());
+            } });
+    }
+    pool.aguarda();
+    return true;
+}
+
+// Johnson com a matriz V × V compacta na memória (linha s a partir de matriz[s * V]).
+// Retorna false se houver ciclo negativo
+template <typename Fonte>
+bool matrizJohnson(const Fonte &grafo, PoolTrabalhadores &pool, vector<int> &matriz)
+{
+    int n = grafo.numVertices;
+    matriz.assign((size_t)n * n, EspacoTrabalho::INF);
+    return todosParesJohnson(grafo, pool, [&matriz, n](int s, const int *linha)
+                             { copy(linha, linha + n, matriz.begin() + (size_t)s * n); });
+}
+
+// Posiciona o arquivo em um deslocamento de 64 bits (matrizes maiores que 2 GB)
+int posicionaArquivo(FILE *arquivo, long long deslocamento)
+{
+#ifdef _WIN32
+    return _fseeki64(arquivo, deslocamento, SEEK_SET);
+#else
+    return fseeko(arquivo, (off_t)deslocamento, SEEK_SET);
+#endif
+}
+
+// Johnson gravando a matriz direto no disco: arquivo binário de V × V inteiros de 32 bits
+// (ordem de bytes da máquina, linha s no deslocamento s * V * 4; INF = 999999).
+// Só as linhas em cálculo ficam na memória. Retorna false se houver ciclo negativo
+// (indicado em cicloNegativo) ou erro de escrita (já informado na saída de erro)
+template <typename Fonte>
+bool arquivoJohnson(const Fonte &grafo, PoolTrabalhadores &pool, const char *caminho, bool &cicloNegativo)
+{
+    cicloNegativo = false;
+    FILE *arquivo = fopen(caminho, "wb");
+    if (arquivo == nullptr)
+    {
+        cerr << "Nao foi possivel criar " << caminho << endl;
+        return false;
+    }
+
+    int n = grafo.numVertices;
+    mutex trava; // As linhas chegam de várias threads
+    bool escreveu = true;
+    bool sucesso = todosParesJohnson(grafo, pool, [&](int s, const int *linha)
+                                     {
+        lock_guard<mutex> guarda(trava);
+        if (posicionaArquivo(arquivo, (long long)s * n * sizeof(int)) != 0 ||
+            fwrite(linha, sizeof(int), n, arquivo) != (size_t)n)
+            escreveu = false; });
+    if (fclose(arquivo) != 0)
+        escreveu = false;
+    cicloNegativo = !sucesso;
+    if (!escreveu)
+        cerr << "Erro ao gravar " << caminho << endl;
+    if (!sucesso || !escreveu)
+        remove(caminho);
+    return sucesso && escreveu;
+}
+
+// Exibe a matriz de distâncias de Johnson no mesmo formato de algoritmoFloyd
+void exibeJohnson(Grafo &g, int numThreads)
+{
+    vector<int> matriz;
+    bool semCiclo;
+    {
+        PoolTrabalhadores pool(numThreads);
+        semCiclo = matrizJohnson(g, pool, matriz);
+    }
+    if (!semCiclo)
+    {
+        cout << "\nO grafo possui ciclo negativo: distancias minimas indefinidas\n";
+        return;
+    }
+
+    cout << "\nMatriz de distancias minimas (Johnson):\n";
+    for (int i = 0; i < g.numVertices; i++)
+    {
+        for (int j = 0; j < g.numVertices; j++)
+        {
+            int d = matriz[(size_t)i * g.numVertices + j];
+            if (d == EspacoTrabalho::INF)
+                cout << "INF\t";
+            else
+                cout << d << "\t";
+        }
+        cout << endl;
+    }
+}
+
+// Servidor de consultas em lote sobre um grafo carregado uma única vez.
+// Lê uma consulta por linha, distribui blocos de consultas entre as threads do pool
+// e escreve as respostas na mesma ordem da entrada, com saída bufferizada.
+// Protocolo (uma linha por consulta, uma linha por resposta; INF = inalcançável):
+//   BFS s       -> BFS s: d0 d1 ... d(V-1)
+//   DIJKSTRA s  -> DIJKSTRA s: d0 d1 ... d(V-1)
+//   DIST s t    -> DIST s t: d           (Dijkstra interrompido ao finalizar t)
+//   MST         -> MST custo: u-v:peso ...  (Kruskal, calculado uma vez)
+//   ESTATISTICAS <consulta> -> contadores da consulta em JSON (requer GRAFO_INSTRUMENTACAO)
+// Fonte é a representação consultada: Grafo ou GrafoComprimido
+template <typename Fonte>
+class ServidorConsultas
+{
+private:
+    const Fonte &g;          // Grafo consultado (somente leitura enquanto o servidor roda)
+    PoolTrabalhadores &pool; // Threads que respondem as consultas
+    const GrafoReordenado *reordenado; // Mapas de identificadores se g foi renumerado
+    once_flag mstCalculada;  // Garante que a MST seja calculada uma única vez
+    string respostaMST;      // Resposta pronta da consulta MST
+
+    static const size_t TAMANHO_LOTE = 4096; // Linhas lidas antes de despachar
+    static const int ESPERA_LOTE_MS = 1;     // Espera por mais linhas antes de despachar um lote incompleto
+
+    // Acrescenta uma distância à saída
+    static void acrescentaDistancia(string &saida, int d)
+    {
+        if (d == EspacoTrabalho::INF)
+            saida += "INF";
+        else
+            saida += to_string(d);
+    }
+
+    // Converte um vértice da consulta para o identificador usado em g
+    int interno(int v) const
+    {
+        return reordenado ? reordenado->novoId[v] : v;
+    }
+
+    // Converte um vértice de g para o identificador original
+    int externo(int v) const
+    {
+        return reordenado ? reordenado->idOriginal[v] : v;
+    }
+
+    // Acrescenta as distâncias de todos os vértices guardadas na área de trabalho,
+    // na ordem dos identificadores originais
+    void acrescentaDistancias(string &saida, const EspacoTrabalho &ws)
+    {
+        for (int i = 0; i < g.numVertices; i++)
+        {
+            saida += ' ';
+            acrescentaDistancia(saida, ws.distancia(interno(i)));
+        }
+    }
+
+    // Monta a resposta da consulta MST
+    void calculaMST()
+    {
+        int custo;
+        vector<Aresta> mst = arvoreKruskal(g, custo);
+        respostaMST = "MST " + to_string(custo) + ":";
+        for (auto &aresta : mst)
+        {
+            int v1 = externo(aresta.origem), v2 = externo(aresta.destino);
+            respostaMST += " " + to_string(min(v1, v2)) + "-" + to_string(max(v1, v2)) + ":" + to_string(aresta.peso);
+        }
+    }
+
+    // Verifica se v é um vértice válido
+    bool verticeValido(int v) const
+    {
+        return v >= 0 && v < g.numVertices;
+    }
+
+    // Responde uma consulta, acrescentando a resposta (sem quebra de linha) à saída
+    void responde(const string &linha, string &saida)
+    {
+        char comando[16];
+        int a = -1, b = -1;
+        int lidos = sscanf(linha.c_str(), "%15s %d %d", comando, &a, &b);
+        if (lidos < 1)
+        {
+            saida += "ERRO consulta vazia";
+            return;
+        }
+
+        string cmd(comando);
+        EspacoTrabalho &ws = EspacoTrabalho::daThread();
+        if (cmd == "ESTATISTICAS")
+        {
+            respondeEstatisticas(linha.substr(linha.find(comando) + cmd.size()), saida);
+            return;
+        }
+        if ((cmd == "BFS" || cmd == "DIJKSTRA") && lidos >= 2)
+        {
+            if (!verticeValido(a))
+            {
+                saida += "ERRO vertice invalido";
+                return;
+            }
+            if (cmd == "BFS")
+                buscaLargura(g, interno(a), ws);
+            else
+                caminhosMinimos(g, interno(a), ws);
+            saida += cmd + " " + to_string(a) + ":";
+            acrescentaDistancias(saida, ws);
+        }
+        else if (cmd == "DIST" && lidos >= 3)
+        {
+            if (!verticeValido(a) || !verticeValido(b))
+            {
+                saida += "ERRO vertice invalido";
+                return;
+            }
+            caminhosMinimos(g, interno(a), ws, interno(b));
+            saida += "DIST " + to_string(a) + " " + to_string(b) + ": ";
+            acrescentaDistancia(saida, ws.distancia(interno(b)));
+        }
+        else if (cmd == "MST")
+        {
+            call_once(mstCalculada, &ServidorConsultas::calculaMST, this);
+            saida += respostaMST;
+        }
+        else
+        {
+            saida += "ERRO consulta desconhecida: " + linha;
+        }
+    }
+
+    // Executa a consulta e responde com os contadores coletados em vez do resultado
+    void respondeEstatisticas(const string &consulta, string &saida)
+    {
+#ifdef GRAFO_INSTRUMENTACAO
+        char comando[16];
+        if (sscanf(consulta.c_str(), "%15s", comando) == 1 && string(comando) == "MST")
+        {
+            // A resposta MST fica em cache; as estatísticas exigem uma execução nova
+            int custo;
+            EstatisticasAlgoritmo estatisticas;
+            arvoreKruskal(g, custo, &estatisticas);
+            saida += "ESTATISTICAS MST: " + estatisticas.paraJSON();
+            return;
+        }
+
+        string resultado;
+        responde(consulta, resultado);
+        if (resultado.compare(0, 4, "ERRO") == 0)
+        {
+            saida += resultado;
+            return;
+        }
+        saida += "ESTATISTICAS" + consulta + ": " + EspacoTrabalho::daThread().estatisticas.paraJSON();
+#else
+        (void)consulta;
+        saida += "ERRO instrumentacao desativada (compile com -DGRAFO_INSTRUMENTACAO)";
+#endif
+    }
+
+    // Despacha um lote de linhas entre as threads e escreve as respostas em ordem
+    void processaLote(const vector<string> &linhas, ostream &saida)
+    {
+        int numBlocos = pool.tamanho() * 4; // Blocos extras equilibram consultas de custo desigual
+        size_t tamanhoBloco = (linhas.size() + numBlocos - 1) / numBlocos;
+        vector<string> respostas((linhas.size() + tamanhoBloco - 1) / tamanhoBloco);
+
+        for (size_t bloco = 0; bloco < respostas.size(); bloco++)
+        {
+            pool.executa([this, &linhas, &respostas, bloco, tamanhoBloco]()
+                         {
+                size_t fim = min(linhas.size(), (bloco + 1) * tamanhoBloco);
+                for (size_t i = bloco * tamanhoBloco; i < fim; i++)
+                {
+                    responde(linhas[i], respostas[bloco]);
+                    respostas[bloco] += '\n';
+                } });
+        }
+        pool.aguarda();
+
+        for (auto &resposta : respostas)
+        {
+            saida.write(resposta.data(), resposta.size());
+        }
+        saida.flush(); // Entrega o lote inteiro de uma vez
+    }
+
+public:
+    // Construtor - se o grafo foi renumerado, consultas e respostas usam os identificadores originais
+    ServidorConsultas(const Fonte &grafo, PoolTrabalhadores &trabalhadores, const GrafoReordenado *mapas = nullptr)
+        : g(grafo), pool(trabalhadores), reordenado(mapas) {}
+
+    // Indica se há mais linhas a ler sem bloquear por mais de ESPERA_LOTE_MS: dados no
+    // buffer do stream ou, se o descritor for conhecido, chegando nele. in_avail() sozinho
+    // quase sempre vale 0 em pipes e sockets, o que reduziria cada lote a uma linha
+    bool haMaisEntrada(istream &entrada, int descritor)
+    {
+        if (entrada.rdbuf()->in_avail() > 0)
+            return true;
+#ifdef GRAFO_PROCESSOS
+        if (descritor >= 0)
+        {
+            pollfd espera = {descritor, POLLIN, 0};
+            return poll(&espera, 1, ESPERA_LOTE_MS) > 0; // Fim da entrada também conta como pronto
+        }
+#else
+        (void)descritor;
+#endif
+        return false;
+    }
+
+    // Atende consultas até o fim da entrada; retorna o número de consultas respondidas.
+    // Um lote é despachado ao encher, no fim da entrada ou quando nada mais chega em
+    // ESPERA_LOTE_MS (descritor é o arquivo sob entrada, ou -1 se não houver)
+    long long atende(istream &entrada, ostream &saida, int descritor = -1)
+    {
+        long long total = 0;
+        vector<string> linhas;
+        linhas.reserve(TAMANHO_LOTE);
+
+        string linha;
+        while (getline(entrada, linha))
+        {
+            if (linha.empty())
+                continue;
+            linhas.push_back(linha);
+
+            // Sem mais dados chegando, responde o que já chegou
+            if (linhas.size() == TAMANHO_LOTE || !haMaisEntrada(entrada, descritor))
+            {
+                processaLote(linhas, saida);
+                total += linhas.size();
+                linhas.clear();
+            }
+        }
+
+        if (!linhas.empty())
+        {
+            processaLote(linhas, saida);
+            total += linhas.size();
+        }
+        return total;
+    }
+};
+
+// Função para criar um grafo de exemplo para testes
+void criarGrafoExemplo(Grafo &g, bool grafoDirecionado, bool grafoPonderado)
+{
+
+    // Adiciona diferentes arestas dependendo das configurações do grafo
+
+    if (grafoDirecionado)
+    {
+        // Grafo direcionado
+        if (grafoPonderado)
+        {
+            // Grafo direcionado e ponderado
+            g.adicionaArestaDirecionada(0, 1, 5);
+            g.adicionaArestaDirecionada(0, 2, 3);
+            g.adicionaArestaDirecionada(1, 3, 7);
+            g.adicionaArestaDirecionada(2, 3, 2);
+            g.adicionaArestaDirecionada(3, 4, 1);
+        }
+        else
+        {
+            // Grafo direcionado não ponderado (peso 1)
+            g.adicionaArestaDirecionada(0, 1, 1);
+            g.adicionaArestaDirecionada(0, 2, 1);
+            g.adicionaArestaDirecionada(1, 3, 1);
+            g.adicionaArestaDirecionada(2, 3, 1);
+            g.adicionaArestaDirecionada(3, 4, 1);
+        }
+    }
+    else
+    {
+        // Grafo não direcionado
+        if (grafoPonderado)
+        {
+            // Grafo não direcionado e ponderado
+            g.adicionaAresta(0, 1, 5);
+            g.adicionaAresta(0, 2, 3);
+            g.adicionaAresta(1, 3, 7);
+            g.adicionaAresta(2, 3, 2);
+            g.adicionaAresta(3, 4, 1);
+        }
+        else
+        {
+            // Grafo não direcionado não ponderado (peso 1)
+            g.adicionaAresta(0, 1, 1);
+            g.adicionaAresta(0, 2, 1);
+            g.adicionaAresta(1, 3, 1);
+            g.adicionaAresta(2, 3, 1);
+            g.adicionaAresta(3, 4, 1);
+        }
+    }
+}
+
+// Carrega um grafo de arquivo texto no formato:
+//   numVertices numArestas direcionado(0/1) ponderado(0/1)
+//   origem destino peso   (uma linha por aresta)
+// Retorna nullptr se o arquivo não puder ser lido
+Grafo *carregaGrafo(const char *caminho)
+{
+    ifstream arquivo(caminho);
+    if (!arquivo)
+    {
+        cerr << "Nao foi possivel abrir o arquivo " << caminho << endl;
+        return nullptr;
+    }
+
+    int numVertices, numArestas, direcionado, ponderado;
+    if (!(arquivo >> numVertices >> numArestas >> direcionado >> ponderado) || numVertices <= 0)
+    {
+        cerr << "Cabecalho invalido em " << caminho << endl;
+        return nullptr;
+    }
+
+    Grafo *g = new Grafo(numVertices, direcionado != 0, ponderado != 0);
+    int v1, v2, peso;
+    for (int i = 0; i < numArestas && arquivo >> v1 >> v2 >> peso; i++)
+    {
+        // Arestas inválidas são ignoradas sem poluir a saída das consultas
+        if (v1 < 0 || v2 < 0 || v1 >= numVertices || v2 >= numVertices || v1 == v2)
+        {
+            cerr << "Aresta invalida ignorada: " << v1 << " " << v2 << endl;
+            continue;
+        }
+        g->adicionaAresta(v1, v2, peso);
+    }
+    return g;
+}
+
+// Atende as consultas da entrada padrão sobre o grafo já carregado e informa a vazão
+template <typename Fonte>
+void atendeConsultas(const Fonte &g, int numThreads, const GrafoReordenado *mapas)
+{
+    long long total;
+    chrono::steady_clock::time_point inicio = chrono::steady_clock::now();
+    {
+        PoolTrabalhadores pool(numThreads);
+        ServidorConsultas<Fonte> servidor(g, pool, mapas);
+        total = servidor.atende(cin, cout, 0); // Descritor da entrada padrão
+    }
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+
+    cerr << total << " consultas em " << segundos << " s";
+    if (segundos > 0)
+        cerr << " (" << (long long)(total / segundos) << " consultas/s)";
+    cerr << endl;
+}
+
+// Modo servidor: carrega o grafo uma vez e responde consultas da entrada padrão.
+// Com um critério de ordenação, os vértices são renumerados antes de atender;
+// com comprimido, as consultas rodam sobre o formato CSR comprimido
+int executaServidor(const char *caminho, int numThreads, OrdenacaoVertices ordenacao, bool comprimido)
+{
+    // Sem renumeração, o formato comprimido é montado direto do arquivo
+    if (comprimido && ordenacao == ORDEM_ORIGINAL)
+    {
+        GrafoComprimido gc;
+        if (!gc.carrega(caminho))
+            return 1;
+        cerr << "Grafo carregado (comprimido): " << gc.numVertices << " vertices, " << gc.numArestas
+             << " arestas, " << gc.memoriaBytes() / 1024 << " KB (listas: " << gc.memoriaListasBytes() / 1024 << " KB)\n";
+        atendeConsultas(gc, numThreads, nullptr);
+        return 0;
+    }
+
+    Grafo *g = carregaGrafo(caminho);
+    if (g == nullptr)
+    {
+        return 1;
+    }
+    cerr << "Grafo carregado: " << g->numVertices << " vertices, " << g->numArestas << " arestas\n";
+
+    GrafoReordenado reordenado;
+    if (ordenacao != ORDEM_ORIGINAL)
+    {
+        exibeLocalidade(cerr, "Antes da reordenacao", calculaLocalidade(*g));
+        reordenaGrafo(*g, ordenacao, reordenado);
+        exibeLocalidade(cerr, "Depois da reordenacao", calculaLocalidade(*reordenado.grafo));
+        delete g; // Só a cópia renumerada é consultada
+        g = nullptr;
+    }
+    Grafo &consultado = reordenado.grafo ? *reordenado.grafo : *g;
+    const GrafoReordenado *mapas = reordenado.grafo ? &reordenado : nullptr;
+
+    if (comprimido)
+    {
+        // A renumeração aproxima os vizinhos e encurta as diferenças codificadas
+        GrafoComprimido gc(consultado);
+        delete reordenado.grafo;
+        reordenado.grafo = nullptr;
+        cerr << "Comprimido: " << gc.memoriaBytes() / 1024 << " KB (listas: " << gc.memoriaListasBytes() / 1024 << " KB)\n";
+        atendeConsultas(gc, numThreads, mapas ? &reordenado : nullptr);
+    }
+    else
+    {
+        atendeConsultas(consultado, numThreads, mapas);
+    }
+
+    delete g;
+    return 0;
+}
+
+// Modo externo: o grafo fica em fragmentos no disco e só vetores de O(V) ficam na memória.
+// algoritmo é bfs (com origem), componentes ou kruskal; o resultado vai para a saída padrão
+// uma linha por vértice ou aresta, e o volume de E/S para a saída de erro
+int executaExterno(const char *caminho, const string &algoritmo, int origem, size_t memoriaMB, int numFragmentos)
+{
+    GrafoExterno g(memoriaMB << 20, numFragmentos);
+    chrono::steady_clock::time_point inicio = chrono::steady_clock::now();
+    if (!g.carrega(caminho))
+        return 1;
+    cerr << "Grafo particionado: " << g.numVertices << " vertices, " << g.numArestas << " arestas em "
+         << chrono::duration<double>(chrono::steady_clock::now() - inicio).count() << " s\n";
+
+    inicio = chrono::steady_clock::now();
+    if (algoritmo == "bfs")
+    {
+        vector<int> dist;
+        int niveis = g.buscaLargura(origem, dist);
+        if (niveis < 0)
+            return 1;
+        if (niveis == 0)
+        {
+            cout << "Entrada invalida\n";
+            return 1;
+        }
+        for (int v = 0; v < g.numVertices; v++)
+        {
+            if (dist[v] >= 0)
+                cout << v << " " << dist[v] << "\n";
+        }
+        cerr << "BFS: " << niveis << " niveis";
+    }
+    else if (algoritmo == "componentes")
+    {
+        vector<int> componente;
+        int total = g.componentesConexas(componente);
+        if (total < 0)
+            return 1;
+        for (int v = 0; v < g.numVertices; v++)
+        {
+            cout << v << " " << componente[v] << "\n";
+        }
+        cerr << "Componentes: " << total;
+    }
+    else if (algoritmo == "kruskal")
+    {
+        long long arestas = 0;
+        long long custo = g.arvoreKruskal([&](const Aresta &a)
+                                          {
+            cout << a.origem << " " << a.destino << " " << a.peso << "\n";
+            arestas++; });
+        if (custo < 0)
+            return 1;
+        cerr << "Kruskal: " << arestas << " arestas, custo " << custo;
+    }
+    else
+    {
+        cout << "Entrada invalida\n";
+        return 1;
+    }
+    cerr << ", " << g.passagens.varreduras << " fragmentos lidos, "
+         << g.passagens.bytesLidos / (1 << 20) << " MB lidos em "
+         << chrono::duration<double>(chrono::steady_clock::now() - inicio).count() << " s\n";
+    return 0;
+}
+
+// Modo fluxo: lê da entrada padrão linhas
+//   ARESTA u v [peso] [instante]   (sem instante, vale a ordem de chegada)
+//   CONECTADOS u v | GRAU v | RESUMO
+// As arestas são aplicadas em lotes; as consultas veem o último lote aplicado.
+// Sem mais dados prontos na entrada, o lote incompleto é aplicado antes de seguir
+int executaFluxo(int numVertices, bool direcionado, size_t tamanhoLote, long long janela)
+{
+    if (numVertices <= 0)
+    {
+        cout << "Entrada invalida\n";
+        return 1;
+    }
+
+    Grafo g(numVertices, direcionado, true);
+    IngestaoFluxo fluxo(g, tamanhoLote, janela);
+    chrono::steady_clock::time_point inicio = chrono::steady_clock::now();
+    long long consultas = 0;
+
+    string linha;
+    string saida;
+    while (getline(cin, linha))
+    {
+        char comando[16];
+        int a = -1, b = -1, peso = 1;
+        long long instante = -1;
+        int lidos = sscanf(linha.c_str(), "%15s %d %d %d %lld", comando, &a, &b, &peso, &instante);
+        if (lidos < 1)
+            continue;
+
+        string cmd(comando);
+        if (cmd == "ARESTA" && lidos >= 3)
+        {
+            EventoAresta e = {a, b, peso, lidos >= 5 ? instante : fluxo.eventosRecebidos};
+            if (!fluxo.recebe(e))
+                saida += "ERRO vertice invalido\n";
+        }
+        else if (cmd == "CONECTADOS" && lidos >= 3)
+        {
+            consultas++;
+            if (a < 0 || b < 0 || a >= numVertices || b >= numVertices)
+                saida += "ERRO vertice invalido\n";
+            else
+                saida += "CONECTADOS " + to_string(a) + " " + to_string(b) + ": " + (fluxo.conectados(a, b) ? "sim\n" : "nao\n");
+        }
+        else if (cmd == "GRAU" && lidos >= 2)
+        {
+            consultas++;
+            if (a < 0 || a >= numVertices)
+                saida += "ERRO vertice invalido\n";
+            else
+                saida += "GRAU " + to_string(a) + ": " + to_string(g.grau[a]) + " ~" + to_string(fluxo.chegadasEstimadas(a)) + "\n";
+        }
+        else if (cmd == "RESUMO")
+        {
+            consultas++;
+            saida += "RESUMO: arestas " + to_string(g.numArestas) + " componentes " + to_string(fluxo.componentes) +
+                     " lotes " + to_string(fluxo.lotesAplicados) + " pendentes " + to_string(fluxo.numPendentes()) +
+                     " expiradas " + to_string(fluxo.arestasExpiradas) + " maisAtivo " + to_string(fluxo.maisAtivo) +
+                     " ~" + to_string(fluxo.chegadasMaisAtivo) + "\n";
+        }
+        else
+        {
+            saida += "ERRO comando desconhecido: " + linha + "\n";
+        }
+
+        // Sem mais dados prontos, aplica o lote incompleto e entrega as respostas
+        if (cin.rdbuf()->in_avail() <= 0)
+        {
+            fluxo.aplicaLote();
+            cout << saida << flush;
+            saida.clear();
+        }
+    }
+    fluxo.aplicaLote();
+    cout << saida << flush;
+
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    cerr << fluxo.eventosRecebidos << " arestas e " << consultas << " consultas em " << segundos << " s";
+    if (segundos > 0)
+        cerr << " (" << (long long)(fluxo.eventosRecebidos / segundos) << " arestas/s)";
+    cerr << ", " << fluxo.lotesAplicados << " lotes, " << g.numArestas << " arestas ativas\n";
+    return 0;
+}
+
+// Modo distribuído: particiona o grafo em k partes e executa BFS ou Bellman-Ford
+// no motor BSP com um processo por parte. As distâncias vão para a saída padrão
+// (uma linha por vértice); corte, fantasmas e superpassos para a saída de erro
+int executaDistribuido(const char *caminho, int k, const string &algoritmo, int origem,
+                       const string &particionador, bool usaProcessos)
+{
+    Grafo *g = carregaGrafo(caminho);
+    if (g == nullptr)
+        return 1;
+    if (k <= 0 || origem < 0 || origem >= g->numVertices ||
+        (algoritmo != "bfs" && algoritmo != "bellman") ||
+        (particionador != "hash" && particionador != "multinivel"))
+    {
+        cout << "Entrada invalida\n";
+        delete g;
+        return 1;
+    }
+
+    chrono::steady_clock::time_point inicio = chrono::steady_clock::now();
+    Particao particao = particionador == "hash" ? particionaHash(*g, k) : particionaMultinivel(*g, k);
+    MotorBSP motor(*g, particao);
+    int maior = *max_element(particao.tamanho.begin(), particao.tamanho.end());
+    cerr << "Particao " << particionador << ": " << k << " partes, " << particao.arestasCortadas << " de "
+         << g->numArestas << " arestas cortadas, " << motor.totalFantasmas() << " fantasmas, maior parte "
+         << maior << " vertices (" << chrono::duration<double>(chrono::steady_clock::now() - inicio).count() << " s)\n";
+
+    inicio = chrono::steady_clock::now();
+    vector<int> dist;
+    bool sucesso = motor.executa(algoritmo == "bfs" ? MotorBSP::BSP_BFS : MotorBSP::BSP_BELLMAN_FORD, origem, dist, usaProcessos);
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+    if (!sucesso)
+    {
+        cout << "Ciclo negativo ou falha de um trabalhador\n";
+        delete g;
+        return 1;
+    }
+
+    string saida;
+    for (int v = 0; v < g->numVertices; v++)
+    {
+        saida += to_string(v) + " ";
+        saida += dist[v] == MotorBSP::INF ? string("INF") : to_string(dist[v]);
+        saida += '\n';
+    }
+    cout << saida;
+    cerr << algoritmo << ": " << motor.superpassos << " superpassos, " << motor.mensagens << " mensagens em "
+         << segundos << " s\n";
+    delete g;
+    return 0;
+}
+
+// Converte um critério de escolha de marcos pelo nome (padrão: distantes)
+SelecaoMarcos selecaoPorNome(const string &nome)
+{
+    if (nome == "aleatorio")
+        return MARCOS_ALEATORIOS;
+    if (nome == "grau")
+        return MARCOS_GRAU;
+    return MARCOS_DISTANTES;
+}
+
+// Modo oráculo: monta a tabela de marcos e responde da entrada padrão
+//   APROX s t -> APROX s t: inferior superior   (limites da distância, INF = desconhecido)
+//   DIST s t  -> DIST s t: d                     (Dijkstra exato, para comparação)
+int executaOraculo(const char *caminho, int numMarcos, SelecaoMarcos criterio, int numThreads)
+{
+    Grafo *g = carregaGrafo(caminho);
+    if (g == nullptr)
+        return 1;
+
+    chrono::steady_clock::time_point inicio = chrono::steady_clock::now();
+    OraculoDistancias *oraculo;
+    {
+        PoolTrabalhadores pool(numThreads);
+        oraculo = new OraculoDistancias(*g, numMarcos, criterio, pool);
+    }
+    cerr << "Oraculo: " << oraculo->listaMarcos().size() << " marcos, " << oraculo->memoriaBytes() / 1024
+         << " KB em " << chrono::duration<double>(chrono::steady_clock::now() - inicio).count() << " s\n";
+
+    string linha, saida;
+    while (getline(cin, linha))
+    {
+        char comando[16];
+        int a = -1, b = -1;
+        if (sscanf(linha.c_str(), "%15s %d %d", comando, &a, &b) < 3)
+        {
+            if (!linha.empty())
+                saida += "ERRO consulta desconhecida: " + linha + "\n";
+            continue;
+        }
+        string cmd(comando);
+        if (a < 0 || b < 0 || a >= g->numVertices || b >= g->numVertices)
+        {
+            saida += "ERRO vertice invalido\n";
+            continue;
+        }
+
+        string prefixo = cmd + " " + to_string(a) + " " + to_string(b) + ": ";
+        if (cmd == "APROX")
+        {
+            OraculoDistancias::Estimativa e = oraculo->estima(a, b);
+            saida += prefixo + (e.inferior == OraculoDistancias::INF ? string("INF") : to_string(e.inferior)) + " " +
+                     (e.superior == OraculoDistancias::INF ? string("INF") : to_string(e.superior)) + "\n";
+        }
+        else if (cmd == "DIST")
+        {
+            EspacoTrabalho &ws = EspacoTrabalho::daThread();
+            caminhosMinimos(*g, a, ws, b);
+            int d = ws.distancia(b);
+            saida += prefixo + (d == EspacoTrabalho::INF ? string("INF") : to_string(d)) + "\n";
+        }
+        else
+        {
+            saida += "ERRO consulta desconhecida: " + linha + "\n";
+        }
+
+        if (cin.rdbuf()->in_avail() <= 0)
+        {
+            cout << saida << flush;
+            saida.clear();
+        }
+    }
+    cout << saida << flush;
+
+    delete oraculo;
+    delete g;
+    return 0;
+}
+
+// Modo Johnson: todos os pares do grafo do arquivo. Com saida, a matriz binária vai
+// para o arquivo (ver arquivoJohnson); sem, é exibida como texto na saída padrão
+int executaJohnson(const char *caminho, int numThreads, const char *saida)
+{
+    Grafo *g = carregaGrafo(caminho);
+    if (g == nullptr)
+        return 1;
+
+    chrono::steady_clock::time_point inicio = chrono::steady_clock::now();
+    bool sucesso, cicloNegativo;
+    if (saida != nullptr)
+    {
+        PoolTrabalhadores pool(numThreads);
+        sucesso = arquivoJohnson(*g, pool, saida, cicloNegativo);
+        if (sucesso)
+            cerr << "Johnson: matriz " << g->numVertices << " x " << g->numVertices << " gravada em " << saida;
+    }
+    else
+    {
+        vector<int> matriz;
+        {
+            PoolTrabalhadores pool(numThreads);
+            sucesso = matrizJohnson(*g, pool, matriz);
+        }
+        cicloNegativo = !sucesso;
+        if (sucesso)
+        {
+            string texto;
+            for (int i = 0; i < g->numVertices; i++)
+            {
+                for (int j = 0; j < g->numVertices; j++)
+                {
+                    int d = matriz[(size_t)i * g->numVertices + j];
+                    texto += j ? " " : "";
+                    texto += d == EspacoTrabalho::INF ? string("INF") : to_string(d);
+                }
+                texto += '\n';
+                cout << texto;
+                texto.clear();
+            }
+            cerr << "Johnson: matriz " << g->numVertices << " x " << g->numVertices;
+        }
+    }
+    if (!sucesso)
+    {
+        // Erros de escrita já foram informados por arquivoJohnson
+        if (cicloNegativo)
+            cerr << "O grafo possui ciclo negativo: distancias minimas indefinidas\n";
+        delete g;
+        return 1;
+    }
+    cerr << " em " << chrono::duration<double>(chrono::steady_clock::now() - inicio).count() << " s\n";
+    delete g;
+    return 0;
+}
+
+// Gera grafo de Erdős–Rényi G(n, m): m arestas entre pares sorteados uniformemente
+Grafo *geraErdosRenyi(int n, long long m, int pesoMax, mt19937 &rng)
+{
+    Grafo *g = new Grafo(n);
+    uniform_int_distribution<int> vertice(0, n - 1), peso(1, pesoMax);
+    for (long long i = 0; i < m; i++)
+    {
+        int v1 = vertice(rng), v2 = vertice(rng);
+        if (v1 != v2)
+            g->adicionaAresta(v1, v2, peso(rng));
+    }
+    return g;
+}
+
+// Gera grafo R-MAT (Kronecker) com 2^escala vértices e fatorArestas * 2^escala arestas sorteadas.
+// Cada aresta desce recursivamente por quadrantes da matriz de adjacência com
+// probabilidades (a, b, c, d) = (0.57, 0.19, 0.19, 0.05), concentrando arestas em hubs
+Grafo *geraRMAT(int escala, int fatorArestas, int pesoMax, mt19937 &rng)
+{
+    int n = 1 << escala;
+    Grafo *g = new Grafo(n);
+    uniform_real_distribution<double> sorteio(0.0, 1.0);
+    uniform_int_distribution<int> peso(1, pesoMax);
+    const double a = 0.57, b = 0.19, c = 0.19;
+
+    long long m = (long long)fatorArestas * n;
+    for (long long i = 0; i < m; i++)
+    {
+        int v1 = 0, v2 = 0;
+        for (int bit = 0; bit < escala; bit++)
+        {
+            double r = sorteio(rng);
+            if (r < a)
+                continue; // Quadrante superior esquerdo
+            else if (r < a + b)
+                v2 |= 1 << bit;
+            else if (r < a + b + c)
+                v1 |= 1 << bit;
+            else
+            {
+                v1 |= 1 << bit;
+                v2 |= 1 << bit;
+            }
+        }
+        if (v1 != v2)
+            g->adicionaAresta(v1, v2, peso(rng));
+    }
+    return g;
+}
+
+// Gera grade 2D linhas x colunas com pesos aleatórios, semelhante a uma malha viária
+Grafo *geraGrade(int linhas, int colunas, int pesoMax, mt19937 &rng)
+{
+    Grafo *g = new Grafo(linhas * colunas);
+    uniform_int_distribution<int> peso(1, pesoMax);
+    for (int linha = 0; linha < linhas; linha++)
+    {
+        for (int coluna = 0; coluna < colunas; coluna++)
+        {
+            int v = linha * colunas + coluna;
+            if (coluna + 1 < colunas)
+                g->adicionaAresta(v, v + 1, peso(rng)); // Vizinho à direita
+            if (linha + 1 < linhas)
+                g->adicionaAresta(v, v + colunas, peso(rng)); // Vizinho abaixo
+        }
+    }
+    return g;
+}
+
+// Liga as componentes do grafo em cadeia com uma aresta de peso aleatório entre
+// representantes consecutivos, tornando-o conexo sem alterar as arestas existentes
+void conectaComponentes(Grafo &g, int pesoMax, mt19937 &rng)
+{
+    DisjointSet ds(g.numVertices);
+    for (int u = 0; u < g.numVertices; u++)
+    {
+        g.paraCadaVizinho(u, [&](int v, int)
+                          { ds.unir(u, v); });
+    }
+
+    uniform_int_distribution<int> peso(1, pesoMax);
+    int anterior = 0;
+    for (int v = 1; v < g.numVertices; v++)
+    {
+        if (ds.find(v) != ds.find(anterior))
+        {
+            g.adicionaAresta(anterior, v, peso(rng));
+            ds.unir(anterior, v);
+            anterior = v;
+        }
+    }
+}
+
+// Gera grafo de lei de potência por ligação preferencial (Barabási–Albert):
+// cada novo vértice se liga a arestasPorVertice vértices escolhidos com
+// probabilidade proporcional ao grau
+Grafo *geraLeiPotencia(int n, int arestasPorVertice, int pesoMax, mt19937 &rng)
+{
+    Grafo *g = new Grafo(n);
+    uniform_int_distribution<int> peso(1, pesoMax);
+    vector<int> extremidades; // Cada vértice aparece uma vez por aresta incidente
+
+    // Núcleo inicial completamente conectado
+    int nucleo = min(n, arestasPorVertice + 1);
+    for (int v1 = 0; v1 < nucleo; v1++)
+    {
+        for (int v2 = v1 + 1; v2 < nucleo; v2++)
+        {
+            g->adicionaAresta(v1, v2, peso(rng));
+            extremidades.push_back(v1);
+            extremidades.push_back(v2);
         }
-
-        return false; // Aresta não encontrada
     }
 
-    // Exibe o grafo (lista de adjacência)
-    void exibeGrafo()
+    for (int v = nucleo; v < n; v++)
     {
-        for (int i = 0; i < numVertices; i++)
+        uniform_int_distribution<size_t> escolha(0, extremidades.size() - 1);
+        for (int k = 0; k < arestasPorVertice; k++)
         {
-            ElemLista *temp = A[i];
-            cout << "Vertice " << i << " -> ";
-
-            // Para cada vértice, exibe seus vizinhos e pesos
-            while (temp != nullptr)
+            int alvo = extremidades[escolha(rng)];
+            int arestasAntes = g->numArestas;
+            g->adicionaAresta(v, alvo, peso(rng));
+            if (g->numArestas != arestasAntes)
             {
-                cout << "(" << temp->vertice << ", peso: " << temp->peso << ")";
-                if (temp->prox != nullptr)
-                    cout << " -> ";
-                temp = temp->prox;
+                extremidades.push_back(v);
+                extremidades.push_back(alvo);
             }
-            cout << endl;
         }
     }
+    return g;
+}
 
-    // Verifica se uma aresta existe no grafo
-    bool arestaExiste(int v1, int v2)
+// Descarta tudo o que for escrito em cout enquanto existir
+// (os algoritmos que exibem resultados são medidos sem o custo do terminal)
+class SaidaSilenciada
+{
+private:
+    // Buffer que aceita e descarta qualquer escrita
+    class BufferNulo : public streambuf
     {
-        // Verifica se os vértices são válidos
-        if (v1 < 0 || v2 < 0 || v1 >= numVertices || v2 >= numVertices || v1 == v2)
+    protected:
+        int overflow(int c)
         {
-            cout << "Entrada invalida\n";
-            return false;
+            return traits_type::not_eof(c);
         }
 
-        // Busca a aresta na lista de adjacência
-        ElemLista *atual = A[v1];
-        while (atual != nullptr && atual->vertice < v2)
+        streamsize xsputn(const char *, streamsize n)
         {
-            atual = atual->prox;
+            return n;
         }
+    };
 
-        // Verifica se encontrou
-        if (atual != nullptr && atual->vertice == v2)
+    BufferNulo nulo;
+    streambuf *original;
+
+public:
+    SaidaSilenciada()
+    {
+        original = cout.rdbuf(&nulo);
+    }
+
+    ~SaidaSilenciada()
+    {
+        cout.rdbuf(original);
+    }
+};
+
+// Mede o tempo de execução de uma função, em segundos.
+// Com mais de uma repetição retorna o menor tempo, descartando aquecimento de cache e alocações
+template <typename Funcao>
+double medeTempo(Funcao f, int repeticoes = 1)
+{
+    double melhor = 0;
+    for (int i = 0; i < repeticoes; i++)
+    {
+        chrono::steady_clock::time_point inicio = chrono::steady_clock::now();
+        f();
+        double tempo = chrono::duration<double>(chrono::steady_clock::now() - inicio).count();
+        if (i == 0 || tempo < melhor)
+            melhor = tempo;
+    }
+    return melhor;
+}
+
+// Pico de memória residente do processo em MB (0 se indisponível na plataforma)
+double picoMemoriaMB()
+{
+#ifdef __linux__
+    struct rusage uso;
+    if (getrusage(RUSAGE_SELF, &uso) == 0)
+        return uso.ru_maxrss / 1024.0; // ru_maxrss vem em KB no Linux
+#endif
+    return 0.0;
+}
+
+// Tempo (em segundos) e pico de memória residente (em MB) de um algoritmo
+struct Medicao
+{
+    double segundos;
+    double picoMB;
+};
+
+// Mede f com medeTempo em um processo filho (com GRAFO_PROCESSOS). O pico do filho
+// começa na memória herdada do pai, então cada medição mostra o pico do próprio
+// algoritmo e não o maior pico anterior; alterações no grafo também ficam no filho.
+// Sem processos (ou se o fork falhar), mede no processo atual
+template <typename Funcao>
+Medicao medeIsolado(Funcao f, int repeticoes = 1)
+{
+    Medicao m;
+#ifdef GRAFO_PROCESSOS
+    int canal[2];
+    if (pipe(canal) == 0)
+    {
+        cout.flush(); // O filho herdaria o buffer pendente e o escreveria de novo
+        pid_t filho = fork();
+        if (filho == 0)
         {
-            return true; // Aresta existe
+            close(canal[0]);
+            m.segundos = medeTempo(f, repeticoes);
+            m.picoMB = picoMemoriaMB();
+            bool enviou = write(canal[1], &m, sizeof(m)) == (ssize_t)sizeof(m);
+            _exit(enviou ? 0 : 1);
         }
-        else
+        close(canal[1]);
+        bool recebeu = false;
+        if (filho > 0)
         {
-            return false; // Aresta não existe
+            recebeu = read(canal[0], &m, sizeof(m)) == (ssize_t)sizeof(m);
+            int status;
+            waitpid(filho, &status, 0);
         }
+        close(canal[0]);
+        if (recebeu)
+            return m;
+        cerr << "Medicao em processo separado falhou; medindo no processo atual\n";
     }
+#endif
+    m.segundos = medeTempo(f, repeticoes);
+    m.picoMB = picoMemoriaMB();
+    return m;
+}
 
-    // Destrutor - libera toda a memória alocada
-    ~Grafo()
+// Exibe uma linha da tabela do benchmark
+void exibeMedicao(const string &grafo, const string &algoritmo, int numVertices, int numArestas, const Medicao &m)
+{
+    cout << left << setw(14) << grafo << setw(16) << algoritmo
+         << right << setw(9) << numVertices << setw(10) << numArestas
+         << setw(12) << fixed << setprecision(3) << m.segundos * 1000.0
+         << setw(14) << setprecision(0) << (m.segundos > 0 ? numArestas / m.segundos : 0.0)
+         << setw(10) << setprecision(1) << m.picoMB << "\n";
+}
+
+// Mede os algoritmos do menu (métodos de Grafo) sobre um grafo gerado, cada um em
+// um processo filho. Os que exibem o resultado são medidos com a saída descartada.
+// Os algoritmos quadráticos ou cúbicos (Floyd, Johnson, Apaga Reverso) rodam na versão pequena;
+// Johnson usa numThreads threads, o mesmo limite da tabela de escalabilidade
+void medeAlgoritmos(const string &nome, Grafo &g, Grafo &pequeno, int numThreads)
+{
+    const int repeticoes = 3;
+    int V = g.numVertices, E = g.numArestas;
+    int VPequeno = pequeno.numVertices, EPequeno = pequeno.numArestas;
+
+    exibeMedicao(nome, "BFS", V, E, medeIsolado([&]()
+                                                { SaidaSilenciada silencio; g.algoritmoBFS(0); }, repeticoes));
+    exibeMedicao(nome, "Dijkstra", V, E, medeIsolado([&]()
+                                                     { SaidaSilenciada silencio; g.algoritmoDijkstra(0); }, repeticoes));
+    exibeMedicao(nome, "Prim", V, E, medeIsolado([&]()
+                                                 { SaidaSilenciada silencio; g.algoritmoPrim(); }, repeticoes));
+    exibeMedicao(nome, "Kruskal", V, E, medeIsolado([&]()
+                                                    { SaidaSilenciada silencio; g.algoritmoKruskal(); }, repeticoes));
+    exibeMedicao(nome, "Ordena arestas", V, E, medeIsolado([&]()
+                                                           { SaidaSilenciada silencio; g.ordenarArestas(true); }, repeticoes));
+    exibeMedicao(nome, "Floyd", VPequeno, EPequeno, medeIsolado([&]()
+                                                                { SaidaSilenciada silencio; pequeno.algoritmoFloyd(); }));
+    exibeMedicao(nome, "Johnson", VPequeno, EPequeno, medeIsolado([&]()
+                                                                  {
+        PoolTrabalhadores pool(numThreads);
+        vector<int> matriz;
+        matrizJohnson(pequeno, pool, matriz); }));
+
+    // Apaga Reverso altera o grafo pequeno; sem processos separados, precisa rodar por último
+    exibeMedicao(nome, "Apaga Reverso", VPequeno, EPequeno, medeIsolado([&]()
+                                                                        { SaidaSilenciada silencio; pequeno.algoritmoApagaReverso(); }));
+}
+
+// Mede a vazão de consultas BFS e Dijkstra com 1, 2, 4, ... até maxThreads threads
+void medeEscalabilidade(const string &nome, Grafo &g, int maxThreads, mt19937 &rng)
+{
+    const int numConsultas = 64;
+    uniform_int_distribution<int> vertice(0, g.numVertices - 1);
+    vector<int> origens(numConsultas);
+    for (int &origem : origens)
     {
-        // Para cada vértice, libera sua lista de adjacência
-        for (int i = 0; i < numVertices; i++)
+        origem = vertice(rng);
+    }
+
+    for (int algoritmo = 0; algoritmo < 2; algoritmo++)
+    {
+        double tempoSequencial = 0;
+        for (int threads = 1; threads <= maxThreads; threads *= 2)
         {
-            ElemLista *temp = A[i];
-            while (temp != nullptr)
-            {
-                ElemLista *toDelete = temp;
-                temp = temp->prox;
-                delete toDelete;
-            }
-        }
+            PoolTrabalhadores pool(threads);
+            double tempo = medeTempo([&]()
+                                     {
+                // Cada thread recebe uma fatia das origens e usa sua própria área de trabalho
+                for (int t = 0; t < threads; t++)
+                {
+                    pool.executa([&, t]()
+                                 {
+                        EspacoTrabalho &ws = EspacoTrabalho::daThread();
+                        for (int i = t; i < numConsultas; i += threads)
+                        {
+                            if (algoritmo == 0)
+                                buscaLargura(g, origens[i], ws);
+                            else
+                                caminhosMinimos(g, origens[i], ws);
+                        } });
+                }
+                pool.aguarda(); });
 
-        // Libera o array de listas
-        delete[] A;
+            if (threads == 1)
+                tempoSequencial = tempo;
+            cout << left << setw(14) << nome << setw(16) << (algoritmo == 0 ? "BFS" : "Dijkstra")
+                 << right << setw(9) << threads
+                 << setw(14) << fixed << setprecision(1) << numConsultas / tempo
+                 << setw(10) << setprecision(2) << tempoSequencial / tempo << "\n";
+        }
     }
-};
+}
 
-// Função para criar um grafo de exemplo para testes
-void criarGrafoExemplo(Grafo &g, bool grafoDirecionado, bool grafoPonderado)
+// Mede a localidade e o tempo de BFS e Dijkstra do grafo em cada critério de renumeração
+void medeReordenacao(const string &nome, Grafo &g)
 {
+    const OrdenacaoVertices criterios[] = {ORDEM_ORIGINAL, ORDEM_RCM, ORDEM_GRAU, ORDEM_BFS};
+    const char *nomesCriterios[] = {"original", "rcm", "grau", "bfs"};
+    EspacoTrabalho &ws = EspacoTrabalho::daThread();
 
-    // Adiciona diferentes arestas dependendo das configurações do grafo
+    for (int c = 0; c < 4; c++)
+    {
+        GrafoReordenado reordenado;
+        reordenaGrafo(g, criterios[c], reordenado);
+        Grafo &r = *reordenado.grafo;
+        int origem = reordenado.novoId[0]; // Mesma origem em todas as numerações
+        MetricasLocalidade m = calculaLocalidade(r);
 
-    if (grafoDirecionado)
+        double tempoBFS = medeTempo([&]()
+                                    { buscaLargura(r, origem, ws); }, 3);
+        double tempoDijkstra = medeTempo([&]()
+                                         { caminhosMinimos(r, origem, ws); }, 3);
+        cout << left << setw(14) << nome << setw(10) << nomesCriterios[c]
+             << right << setw(10) << m.larguraBanda
+             << setw(12) << fixed << setprecision(1) << m.distanciaMedia
+             << setw(10) << m.fracaoProxima * 100
+             << setw(10) << setprecision(3) << tempoBFS * 1000.0
+             << setw(14) << tempoDijkstra * 1000.0 << "\n";
+    }
+}
+
+// Compara memória e tempo de BFS, Dijkstra e Prim entre listas encadeadas e CSR comprimido
+// (o grafo comprimido é montado após a renumeração RCM, que encurta as diferenças)
+void medeCompressao(const string &nome, Grafo &g)
+{
+    EspacoTrabalho &ws = EspacoTrabalho::daThread();
+    GrafoReordenado reordenado;
+    reordenaGrafo(g, ORDEM_RCM, reordenado);
+    GrafoComprimido comprimido(g), comprimidoRCM(*reordenado.grafo);
+
+    const char *formatos[] = {"listas", "comprimido", "comp.+rcm"};
+    for (int f = 0; f < 3; f++)
     {
-        // Grafo direcionado
-        if (grafoPonderado)
+        double memoria, tempoBFS, tempoDijkstra, tempoPrim;
+        if (f == 0)
         {
-            // Grafo direcionado e ponderado
-            g.adicionaArestaDirecionada(0, 1, 5);
-            g.adicionaArestaDirecionada(0, 2, 3);
-            g.adicionaArestaDirecionada(1, 3, 7);
-            g.adicionaArestaDirecionada(2, 3, 2);
-            g.adicionaArestaDirecionada(3, 4, 1);
+            memoria = comprimido.memoriaListasBytes();
+            tempoBFS = medeTempo([&]()
+                                 { buscaLargura(g, 0, ws); }, 3);
+            tempoDijkstra = medeTempo([&]()
+                                      { caminhosMinimos(g, 0, ws); }, 3);
+            tempoPrim = medeTempo([&]()
+                                  { arvorePrim(g, 0, ws); }, 3);
         }
         else
         {
-            // Grafo direcionado não ponderado (peso 1)
-            g.adicionaArestaDirecionada(0, 1, 1);
-            g.adicionaArestaDirecionada(0, 2, 1);
-            g.adicionaArestaDirecionada(1, 3, 1);
-            g.adicionaArestaDirecionada(2, 3, 1);
-            g.adicionaArestaDirecionada(3, 4, 1);
+            GrafoComprimido &c = f == 1 ? comprimido : comprimidoRCM;
+            int origem = f == 1 ? 0 : reordenado.novoId[0];
+            memoria = c.memoriaBytes();
+            tempoBFS = medeTempo([&]()
+                                 { buscaLargura(c, origem, ws); }, 3);
+            tempoDijkstra = medeTempo([&]()
+                                      { caminhosMinimos(c, origem, ws); }, 3);
+            tempoPrim = medeTempo([&]()
+                                  { arvorePrim(c, origem, ws); }, 3);
         }
+        cout << left << setw(14) << nome << setw(12) << formatos[f]
+             << right << setw(12) << fixed << setprecision(1) << memoria / (1024.0 * 1024.0)
+             << setw(10) << setprecision(3) << tempoBFS * 1000.0
+             << setw(14) << tempoDijkstra * 1000.0
+             << setw(10) << tempoPrim * 1000.0 << "\n";
     }
-    else
+}
+
+// Modo benchmark: gera grafos sintéticos com 2^escala vértices e mede cada algoritmo
+// (a grade tem 2^(escala/2) linhas e 2^(escala - escala/2) colunas)
+int executaBenchmark(int escala, int maxThreads)
+{
+    if (escala < 4 || escala > 24)
     {
-        // Grafo não direcionado
-        if (grafoPonderado)
-        {
-            // Grafo não direcionado e ponderado
-            g.adicionaAresta(0, 1, 5);
-            g.adicionaAresta(0, 2, 3);
-            g.adicionaAresta(1, 3, 7);
-            g.adicionaAresta(2, 3, 2);
-            g.adicionaAresta(3, 4, 1);
-        }
-        else
-        {
-            // Grafo não direcionado não ponderado (peso 1)
-            g.adicionaAresta(0, 1, 1);
-            g.adicionaAresta(0, 2, 1);
-            g.adicionaAresta(1, 3, 1);
-            g.adicionaAresta(2, 3, 1);
-            g.adicionaAresta(3, 4, 1);
-        }
+        cerr << "Escala deve estar entre 4 e 24\n";
+        return 1;
+    }
+    if (maxThreads < 1)
+        maxThreads = 1;
+
+    mt19937 rng(12345); // Semente fixa para resultados comparáveis entre execuções
+    const int pesoMax = 100;
+    int n = 1 << escala;
+    int escalaPequena = min(escala, 8); // Tamanho para Floyd e Apaga Reverso
+    int nPequeno = 1 << escalaPequena;
+    int linhas = 1 << (escala / 2), linhasPequena = 1 << (escalaPequena / 2);
+
+    // Cada família é gerada em tamanho completo e pequeno
+    vector<string> nomes;
+    vector<Grafo *> grafos, pequenos;
+    double tempoGeracao = medeTempo([&]()
+                                    {
+        nomes.push_back("R-MAT");
+        grafos.push_back(geraRMAT(escala, 16, pesoMax, rng));
+        pequenos.push_back(geraRMAT(escalaPequena, 16, pesoMax, rng));
+        conectaComponentes(*pequenos.back(), pesoMax, rng); // R-MAT deixa vértices isolados; Apaga Reverso exige grafo conexo
+
+        nomes.push_back("Erdos-Renyi");
+        grafos.push_back(geraErdosRenyi(n, 8LL * n, pesoMax, rng));
+        pequenos.push_back(geraErdosRenyi(nPequeno, 8LL * nPequeno, pesoMax, rng));
+
+        nomes.push_back("Grade 2D");
+        grafos.push_back(geraGrade(linhas, n / linhas, pesoMax, rng));
+        pequenos.push_back(geraGrade(linhasPequena, nPequeno / linhasPequena, pesoMax, rng));
+
+        nomes.push_back("Lei potencia");
+        grafos.push_back(geraLeiPotencia(n, 8, pesoMax, rng));
+        pequenos.push_back(geraLeiPotencia(nPequeno, 8, pesoMax, rng)); });
+    cout << "Grafos gerados em " << fixed << setprecision(2) << tempoGeracao << " s\n\n";
+
+    cout << left << setw(14) << "Grafo" << setw(16) << "Algoritmo"
+         << right << setw(9) << "V" << setw(10) << "E" << setw(12) << "Tempo(ms)"
+         << setw(14) << "Arestas/s" << setw(10) << "RSS(MB)" << "\n";
+    for (size_t i = 0; i < grafos.size(); i++)
+    {
+        medeAlgoritmos(nomes[i], *grafos[i], *pequenos[i], maxThreads);
+    }
+
+    cout << "\n"
+         << left << setw(14) << "Grafo" << setw(16) << "Consulta"
+         << right << setw(9) << "Threads" << setw(14) << "Consultas/s" << setw(10) << "Speedup" << "\n";
+    for (size_t i = 0; i < grafos.size(); i++)
+    {
+        medeEscalabilidade(nomes[i], *grafos[i], maxThreads, rng);
+    }
+
+    cout << "\n"
+         << left << setw(14) << "Grafo" << setw(10) << "Ordem"
+         << right << setw(10) << "Banda" << setw(12) << "Dist.media" << setw(10) << "Prox.(%)"
+         << setw(10) << "BFS(ms)" << setw(14) << "Dijkstra(ms)" << "\n";
+    for (size_t i = 0; i < grafos.size(); i++)
+    {
+        medeReordenacao(nomes[i], *grafos[i]);
+    }
+
+    cout << "\n"
+         << left << setw(14) << "Grafo" << setw(12) << "Formato"
+         << right << setw(12) << "Memoria(MB)" << setw(10) << "BFS(ms)"
+         << setw(14) << "Dijkstra(ms)" << setw(10) << "Prim(ms)" << "\n";
+    for (size_t i = 0; i < grafos.size(); i++)
+    {
+        medeCompressao(nomes[i], *grafos[i]);
+    }
+
+    for (size_t i = 0; i < grafos.size(); i++)
+    {
+        delete grafos[i];
+        delete pequenos[i];
     }
+    return 0;
 }
 
 // Função principal
-int main()
+int main(int argc, char *argv[])
 {
+    // Antes de qualquer E/S: nenhum modo mistura stdio com iostream
+    ios::sync_with_stdio(false);
+
+    // Modo servidor: trabalho_grafo --servidor arquivo [threads] [original|rcm|grau|bfs] [comprimido]
+    if (argc >= 3 && string(argv[1]) == "--servidor")
+    {
+        int numThreads = argc >= 4 ? atoi(argv[3]) : (int)thread::hardware_concurrency();
+        OrdenacaoVertices ordenacao = ORDEM_ORIGINAL;
+        if (argc >= 5 && !ordenacaoPorNome(argv[4], ordenacao))
+        {
+            cerr << "Ordenacao desconhecida: " << argv[4] << "\n"
+                 << "Uso: trabalho_grafo --servidor arquivo [threads] [original|rcm|grau|bfs] [comprimido]\n";
+            return 1;
+        }
+        bool comprimido = argc >= 6 && string(argv[5]) == "comprimido";
+        return executaServidor(argv[2], numThreads, ordenacao, comprimido);
+    }
+
+    // Modo externo: trabalho_grafo --externo arquivo (bfs origem | componentes | kruskal) [memoriaMB] [fragmentos]
+    if (argc >= 4 && string(argv[1]) == "--externo")
+    {
+        string algoritmo = argv[3];
+        int proximo = algoritmo == "bfs" ? 5 : 4;
+        int origem = algoritmo == "bfs" && argc >= 5 ? atoi(argv[4]) : -1;
+        size_t memoriaMB = argc > proximo ? (size_t)max(1, atoi(argv[proximo])) : 64;
+        int numFragmentos = argc > proximo + 1 ? atoi(argv[proximo + 1]) : 16;
+        return executaExterno(argv[2], algoritmo, origem, memoriaMB, numFragmentos);
+    }
+
+    // Modo fluxo: trabalho_grafo --fluxo numVertices [direcionado(0/1)] [lote] [janela]
+    if (argc >= 3 && string(argv[1]) == "--fluxo")
+    {
+        bool direcionado = argc >= 4 && atoi(argv[3]) != 0;
+        size_t tamanhoLote = argc >= 5 ? (size_t)max(1, atoi(argv[4])) : 4096;
+        long long janela = argc >= 6 ? atoll(argv[5]) : 0;
+        return executaFluxo(atoi(argv[2]), direcionado, tamanhoLote, janela);
+    }
+
+    // Modo distribuído: trabalho_grafo --distribuido arquivo partes (bfs|bellman) origem [hash|multinivel] [threads]
+    if (argc >= 6 && string(argv[1]) == "--distribuido")
+    {
+        string particionador = argc >= 7 ? argv[6] : "multinivel";
+        bool usaProcessos = !(argc >= 8 && string(argv[7]) == "threads");
+        return executaDistribuido(argv[2], atoi(argv[3]), argv[4], atoi(argv[5]), particionador, usaProcessos);
+    }
+
+    // Modo oráculo: trabalho_grafo --oraculo arquivo [marcos] [aleatorio|grau|distante] [threads]
+    if (argc >= 3 && string(argv[1]) == "--oraculo")
+    {
+        int numMarcos = argc >= 4 ? atoi(argv[3]) : 16;
+        SelecaoMarcos criterio = argc >= 5 ? selecaoPorNome(argv[4]) : MARCOS_DISTANTES;
+        int numThreads = argc >= 6 ? atoi(argv[5]) : (int)thread::hardware_concurrency();
+        return executaOraculo(argv[2], numMarcos, criterio, numThreads);
+    }
+
+    // Modo Johnson: trabalho_grafo --johnson arquivo [threads] [saida.bin]
+    if (argc >= 3 && string(argv[1]) == "--johnson")
+    {
+        int numThreads = argc >= 4 ? atoi(argv[3]) : (int)thread::hardware_concurrency();
+        return executaJohnson(argv[2], numThreads, argc >= 5 ? argv[4] : nullptr);
+    }
+
+    // Modo benchmark: trabalho_grafo --benchmark [escala] [threads]
+    if (argc >= 2 && string(argv[1]) == "--benchmark")
+    {
+        int escala = argc >= 3 ? atoi(argv[2]) : 14;
+        int numThreads = argc >= 4 ? atoi(argv[3]) : (int)thread::hardware_concurrency();
+        return executaBenchmark(escala, numThreads);
+    }
+
     bool grafoDirecionado, grafoPonderado;
 
     // Solicita configurações do grafo ao usuário
@@ -846,7 +6466,7 @@ int main()
 
     // Cria grafo com 5 vértices
     int numVertices = 5;
-    Grafo g(numVertices);
+    Grafo g(numVertices, grafoDirecionado, grafoPonderado);
 
     // Popula grafo com exemplo
     criarGrafoExemplo(g, grafoDirecionado, grafoPonderado);
@@ -869,6 +6489,10 @@ int main()
         cout << "08. Arvore geradora minima - Prim\n";
         cout << "09. Arvore geradora minima - ApagaReservo\n";
         cout << "10. Ordenacao de arestas por peso (crescente/decrescente)\n";
+        cout << "12. Menor caminho dinamico (atualizacao incremental de arestas)\n";
+        cout << "13. Arvore geradora minima dinamica (atualizacao incremental de arestas)\n";
+        cout << "14. Consultas concorrentes com versoes do grafo (BFS durante escritas)\n";
+        cout << "15. Menor caminho entre todos os pares - Johnson (aceita pesos negativos)\n";
         cout << "11. Sair\n";
         cout << "Escolha uma opcao: ";
         cin >> opcao;
@@ -1013,6 +6637,180 @@ int main()
             sair = true;
             break;
 
+        case 12: // Caminho mínimo mantido incrementalmente durante alterações de arestas
+        {
+            cout << "\n=== MENOR CAMINHO DINAMICO ===\n";
+            cout << "Digite o vertice inicial: ";
+            cin >> verticeInicial;
+            if (verticeInicial < 0 || verticeInicial >= g.numVertices)
+            {
+                cout << "Entrada invalida\n";
+                break;
+            }
+
+            CaminhoMinimoDinamico caminhos(g, verticeInicial);
+            if (!caminhos.valido())
+                break;
+            caminhos.exibeDistancias();
+
+            // Submenu de atualizações - cada alteração repara apenas a parte afetada
+            char acao = ' ';
+            while (acao != 'v' && acao != 'V')
+            {
+                cout << "\n(a)dicionar aresta, (r)emover aresta, alterar (p)eso ou (v)oltar? ";
+                cin >> acao;
+
+                if (acao == 'a' || acao == 'A')
+                {
+                    cout << "Digite origem, destino e peso: ";
+                    cin >> v1 >> v2 >> peso;
+                    if (!caminhos.adicionaAresta(v1, v2, peso))
+                        cout << "Aresta nao adicionada\n";
+                }
+                else if (acao == 'r' || acao == 'R')
+                {
+                    cout << "Digite origem e destino: ";
+                    cin >> v1 >> v2;
+                    if (!caminhos.removeAresta(v1, v2))
+                        cout << "Aresta nao encontrada\n";
+                }
+                else if (acao == 'p' || acao == 'P')
+                {
+                    cout << "Digite origem, destino e novo peso: ";
+                    cin >> v1 >> v2 >> peso;
+                    if (!caminhos.alteraPeso(v1, v2, peso))
+                        cout << "Peso nao alterado\n";
+                }
+                else
+                {
+                    continue;
+                }
+                caminhos.exibeDistancias();
+            }
+            break;
+        }
+
+        case 13: // Árvore geradora mínima mantida durante alterações de arestas
+        {
+            if (grafoDirecionado || !grafoPonderado)
+            {
+                cout << "\nEsta opcao so pode ser utilizada em grafos nao direcionados ponderados!\n";
+                break;
+            }
+
+            cout << "\n=== ARVORE GERADORA MINIMA DINAMICA ===\n";
+            ArvoreGeradoraDinamica arvore(g);
+            arvore.exibe();
+
+            // Submenu de atualizações - a árvore é corrigida a cada alteração
+            char acao = ' ';
+            while (acao != 'v' && acao != 'V')
+            {
+                cout << "\n(a)dicionar aresta, (r)emover aresta ou (v)oltar? ";
+                cin >> acao;
+
+                if (acao == 'a' || acao == 'A')
+                {
+                    cout << "Digite origem, destino e peso: ";
+                    cin >> v1 >> v2 >> peso;
+                    if (!arvore.adicionaAresta(v1, v2, peso))
+                        cout << "Aresta nao adicionada\n";
+                }
+                else if (acao == 'r' || acao == 'R')
+                {
+                    cout << "Digite origem e destino: ";
+                    cin >> v1 >> v2;
+                    if (!arvore.removeAresta(v1, v2))
+                        cout << "Aresta nao encontrada\n";
+                }
+                else
+                {
+                    continue;
+                }
+                arvore.exibe();
+            }
+            break;
+        }
+
+        case 14: // Leitores executando BFS enquanto um escritor altera o grafo
+        {
+            cout << "\n=== CONSULTAS CONCORRENTES COM VERSOES DO GRAFO ===\n";
+            cout << "Digite o vertice inicial: ";
+            cin >> verticeInicial;
+            if (verticeInicial < 0 || verticeInicial >= g.numVertices)
+            {
+                cout << "Entrada invalida\n";
+                break;
+            }
+
+            GrafoVersionado versionado(g);
+            atomic<bool> escrevendo(true);
+            atomic<long long> consultas(0);
+            const int numLeitores = 4;
+
+            // Cada leitor fixa uma versão e roda BFS sem travas
+            auto leitor = [&]()
+            {
+                while (escrevendo.load())
+                {
+                    GrafoVersionado::Leitura leitura(versionado);
+                    leitura->distanciasBFS(verticeInicial);
+                    consultas++;
+                }
+            };
+            vector<thread> leitores;
+            for (int t = 0; t < numLeitores; t++)
+            {
+                leitores.push_back(thread(leitor));
+            }
+
+            // O escritor alterna inserções e remoções de todas as arestas possíveis
+            for (int rodada = 0; rodada < 100; rodada++)
+            {
+                for (int i = 0; i < g.numVertices; i++)
+                {
+                    for (int j = i + 1; j < g.numVertices; j++)
+                    {
+                        if (!versionado.adicionaAresta(i, j, 1 + rodada % 9))
+                            versionado.removeAresta(i, j);
+                    }
+                }
+            }
+            escrevendo.store(false);
+            for (auto &t : leitores)
+            {
+                t.join();
+            }
+
+            cout << "Consultas BFS concluidas: " << consultas.load() << "\n";
+            cout << "Versoes publicadas: " << versionado.numeroVersao() << "\n";
+            cout << "Versoes antigas liberadas: " << versionado.versoesRecicladas() << "\n";
+
+            GrafoVersionado::Leitura ultima(versionado);
+            DistanciasConsulta dist = ultima->distanciasBFS(verticeInicial);
+            cout << "\nDistancias a partir do vertice " << verticeInicial << " (usando BFS na ultima versao):\n";
+            for (int i = 0; i < g.numVertices; i++)
+            {
+                if (dist[i] == EspacoTrabalho::INF)
+                    cout << "Vertice " << i << ": INFINITO\n";
+                else
+                    cout << "Vertice " << i << ": " << dist[i] << "\n";
+            }
+            break;
+        }
+
+        case 15: // Johnson para todos os pares (pesos negativos permitidos)
+            if (grafoPonderado)
+            {
+                cout << "\n=== MENOR CAMINHO ENTRE TODOS OS PARES (JOHNSON) ===\n";
+                exibeJohnson(g, (int)thread::hardware_concurrency());
+            }
+            else
+            {
+                cout << "\nEsta opcao so pode ser utilizada em grafos ponderados!\n";
+            }
+            break;
+
         default: // Opção inválida
             cout << "Opcao invalida! Tente novamente.\n";
             break;